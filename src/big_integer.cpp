@@ -7,135 +7,949 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <utility>
 
 // Big integer class
 class BigInt{
+public:
+
+	typedef unsigned long long int limb; // Single digit of base 2^64
+	typedef unsigned __int128 dlimb; // Double limb for carries and products
+
 private:
-	
+
+	// ----------------------------------------------------------------------------------
+	// Limb array keeping up to INLINE_LIMBS limbs in place without heap allocation.
+	// Inline size covers a product of two 128-bit values.
+
+	class LimbStorage{
+	private:
+		static const size_t INLINE_LIMBS = 4;
+		limb *pointer; // Points inlined or heap block
+		size_t length, capacity;
+		limb inlined[INLINE_LIMBS];
+
+		bool isInline() const{return pointer == inlined;}
+		void release(){
+			if(!isInline()) delete[] pointer;
+			pointer = inlined; capacity = INLINE_LIMBS;
+		}
+
+	public:
+		LimbStorage(): pointer(inlined), length(0), capacity(INLINE_LIMBS){}
+		LimbStorage(const limb *first, const limb *last): LimbStorage(){
+			resize(last - first);
+			std::copy(first, last, pointer);
+		}
+		LimbStorage(const LimbStorage &another): LimbStorage(another.pointer, another.pointer + another.length){}
+		LimbStorage(LimbStorage &&another) noexcept: LimbStorage(){*this = std::move(another);}
+		~LimbStorage(){release();}
+
+		LimbStorage& operator =(const LimbStorage &another){ // Reuse capacity if possible
+			if(this == &another) return *this;
+			length = 0; resize(another.length);
+			std::copy(another.pointer, another.pointer + another.length, pointer);
+			return *this;
+		}
+		LimbStorage& operator =(LimbStorage &&another) noexcept{ // Steal heap block
+			if(this == &another) return *this;
+			if(another.isInline()){
+				length = another.length;
+				std::copy(another.pointer, another.pointer + length, pointer);
+			}
+			else{
+				release();
+				pointer = another.pointer, length = another.length, capacity = another.capacity;
+				another.pointer = another.inlined, another.capacity = INLINE_LIMBS;
+			}
+			another.length = 0;
+			return *this;
+		}
+
+		void reserve(size_t n){
+			if(n <= capacity) return;
+			size_t newCapacity = std::max(n, 2*capacity);
+			limb *block = new limb[newCapacity];
+			std::copy(pointer, pointer + length, block);
+			release();
+			pointer = block, capacity = newCapacity;
+		}
+		void resize(size_t n, limb value = 0){
+			reserve(n);
+			if(n > length) std::fill(pointer + length, pointer + n, value);
+			length = n;
+		}
+		void push_back(limb value){reserve(length+1); pointer[length++] = value;}
+		void pop_back(){length--;}
+		void clear(){length = 0;}
+
+		size_t size() const{return length;}
+		bool empty() const{return length == 0;}
+		limb* data(){return pointer;}
+		const limb* data() const{return pointer;}
+		limb& operator [](size_t index){return pointer[index];}
+		const limb& operator [](size_t index) const{return pointer[index];}
+		limb& back(){return pointer[length-1];}
+		const limb& back() const{return pointer[length-1];}
+
+		bool operator ==(const LimbStorage &another) const{
+			return length == another.length && std::equal(pointer, pointer + length, another.pointer);
+		}
+	};
+
 	// ----------------------------------------------------------------------------------
 	// Attributes
-	
+
 	bool sign; // + or -. Zero is considered as positive.
-	std::vector<int> digits; // Each digit stores 10^4. Eariler index stores lower digit area.
-	const static int onesize = 10000;
-	
+	LimbStorage limbs; // Base 2^64 digits. Earlier index stores lower digit area.
+
+	// Multiplication algorithm thresholds, in limbs of shorter operand.
+	static const size_t KARATSUBA_THRESHOLD = 24; // Schoolbook below this
+	static const size_t TOOM3_THRESHOLD = 160; // Karatsuba below this
+	static const size_t NTT_THRESHOLD = 16000; // Toom-3 below this
+	static const size_t NTT_MAX_LIMBS = 1 << 22; // n+m limit of one transform; 2(n+m) pieces <= 2^23
+
+	// Knuth's algorithm D is used while divisor or quotient is shorter than this.
+	static const size_t NEWTON_DIVISION_THRESHOLD = 3000;
+
 	// ----------------------------------------------------------------------------------
 	// Helper functions
-	
+
 	// Remove unnecessary zero
 	void cleanBack(){
-		while(!digits.empty() && digits.back() == 0) digits.pop_back();
-		if(digits.empty()) sign = true;
+		while(!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+		if(limbs.empty()) sign = true;
+	}
+
+	// Make non-negative BigInt from limb range
+	static BigInt fromLimbs(const limb *a, size_t n){
+		BigInt result;
+		result.limbs = LimbStorage(a, a+n);
+		result.cleanBack();
+		return result;
+	}
+
+	// ----------------------------------------------------------------------------------
+	// Limb kernels, working on magnitudes only
+
+	// Compare a[0, n) and b[0, m) without leading zeros; Returns -1, 0 or 1.
+	static int compareLimbs(const limb *a, size_t n, const limb *b, size_t m){
+		if(n != m) return n < m ? -1 : 1;
+		for(size_t i=n; i-->0;) if(a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+		return 0;
+	}
+
+	// r[0, n) = a[0, n) + b[0, m) where n >= m; Returns carry. r may alias a or b.
+	static limb addLimbs(limb *r, const limb *a, size_t n, const limb *b, size_t m){
+		limb carry = 0;
+		for(size_t i=0; i<m; i++){
+			dlimb s = (dlimb)a[i] + b[i] + carry;
+			r[i] = (limb)s; carry = (limb)(s >> 64);
+		}
+		for(size_t i=m; i<n; i++){
+			r[i] = a[i] + carry;
+			carry = (r[i] < carry);
+		} return carry;
+	}
+
+	// r[0, n) = a[0, n) - b[0, m) where n >= m; Returns borrow. r may alias a or b.
+	static limb subLimbs(limb *r, const limb *a, size_t n, const limb *b, size_t m){
+		limb borrow = 0;
+		for(size_t i=0; i<m; i++){
+			limb x = a[i], y = b[i];
+			r[i] = x - y - borrow;
+			borrow = (x < y) || (x - y < borrow);
+		}
+		for(size_t i=m; i<n; i++){
+			limb x = a[i];
+			r[i] = x - borrow;
+			borrow = (x < borrow);
+		} return borrow;
+	}
+
+	// a[0, n) = a[0, n) * m + add; Returns carry.
+	static limb mulSmallLimbs(limb *a, size_t n, limb m, limb add){
+		limb carry = add;
+		for(size_t i=0; i<n; i++){
+			dlimb p = (dlimb)a[i] * m + carry;
+			a[i] = (limb)p; carry = (limb)(p >> 64);
+		} return carry;
+	}
+
+	// a[0, n) = a[0, n) / d; Returns remainder.
+	static limb divSmallLimbs(limb *a, size_t n, limb d){
+		dlimb rem = 0;
+		for(size_t i=n; i-->0;){
+			dlimb cur = (rem << 64) | a[i];
+			a[i] = (limb)(cur / d); rem = cur % d;
+		} return (limb)rem;
+	}
+
+	// r[0, n+m) = a[0, n) * b[0, m)
+	static void mulSchoolbook(limb *r, const limb *a, size_t n, const limb *b, size_t m){
+		std::fill(r, r+n+m, 0);
+		for(size_t i=0; i<n; i++){
+			limb carry = 0;
+			for(size_t j=0; j<m; j++){
+				dlimb p = (dlimb)a[i] * b[j] + r[i+j] + carry;
+				r[i+j] = (limb)p; carry = (limb)(p >> 64);
+			} r[i+m] = carry;
+		}
+	}
+
+	// r[0, 2n) = a[0, n) * b[0, n)
+	static void mulKaratsuba(limb *r, const limb *a, const limb *b, size_t n){
+		if(n < KARATSUBA_THRESHOLD){
+			mulSchoolbook(r, a, n, b, n);
+			return;
+		}
+
+		// (a1 B^h + a0)(b1 B^h + b0) = z0 + (z1 - z0 - z2) B^h + z2 B^2h
+		const size_t h = n/2, k = n-h;
+		std::vector<limb> asum(k+1), bsum(k+1), z1(2*k+2);
+		asum[k] = addLimbs(asum.data(), a+h, k, a, h);
+		bsum[k] = addLimbs(bsum.data(), b+h, k, b, h);
+		mulKaratsuba(r, a, b, h); // z0 into r[0, 2h)
+		mulKaratsuba(r+2*h, a+h, b+h, k); // z2 into r[2h, 2n)
+		multiplyLimbs(z1.data(), asum.data(), k+1, bsum.data(), k+1);
+		subLimbs(z1.data(), z1.data(), 2*k+2, r, 2*h);
+		subLimbs(z1.data(), z1.data(), 2*k+2, r+2*h, 2*k);
+		size_t len = 2*k+2;
+		while(len > 0 && z1[len-1] == 0) len--;
+		addLimbs(r+h, r+h, 2*n-h, z1.data(), len);
+	}
+
+	// r[0, n+m) = a[0, n) * b[0, m) by Toom-3 with Bodrato's interpolation.
+	static void mulToom3(limb *r, const limb *a, size_t n, const limb *b, size_t m){
+		const size_t k = (std::max(n, m) + 2) / 3;
+		auto part = [k](const limb *x, size_t len, size_t index) -> BigInt{
+			size_t from = std::min(len, index*k), to = std::min(len, (index+1)*k);
+			return fromLimbs(x+from, to-from);
+		};
+		BigInt a0 = part(a, n, 0), a1 = part(a, n, 1), a2 = part(a, n, 2),
+		       b0 = part(b, m, 0), b1 = part(b, m, 1), b2 = part(b, m, 2);
+
+		// Evaluate at 0, 1, -1, -2, inf
+		BigInt pt = a0 + a2, qt = b0 + b2;
+		BigInt p1 = pt + a1, pm1 = pt - a1, q1 = qt + b1, qm1 = qt - b1;
+		BigInt pm2 = (pm1 + a2) * BigInt(2) - a0, qm2 = (qm1 + b2) * BigInt(2) - b0;
+		BigInt r0 = a0 * b0, r1 = p1 * q1, rm1 = pm1 * qm1, rm2 = pm2 * qm2, rinf = a2 * b2;
+
+		// Interpolate
+		BigInt c3 = rm2 - r1; c3.divSmall(3);
+		BigInt c1 = r1 - rm1; c1.divSmall(2);
+		BigInt c2 = rm1 - r0;
+		c3 = c2 - c3; c3.divSmall(2); c3 += rinf * BigInt(2);
+		c2 += c1 - rinf;
+		c1 -= c3;
+
+		// Recompose r0 + c1 x + c2 x^2 + c3 x^3 + rinf x^4 with x = B^k
+		std::fill(r, r+n+m, 0);
+		const BigInt *coefficients[] = {&r0, &c1, &c2, &c3, &rinf};
+		for(int i=0; i<5; i++){
+			const LimbStorage &c = coefficients[i]->limbs;
+			if(c.empty() || i*k >= n+m) continue;
+			size_t offset = i*k, len = std::min(c.size(), n+m-offset);
+			addLimbs(r+offset, r+offset, n+m-offset, c.data(), len);
+		}
+	}
+
+	// NTT over one prime with primitive root 3; a.size() should be power of 2.
+	template <unsigned int mod> static void ntt(std::vector<unsigned int> &a, bool invert){
+		auto power = [](unsigned long long x, unsigned long long e) -> unsigned long long{
+			unsigned long long result = 1;
+			for(; e > 0; e >>= 1, x = x * x % mod) if(e&1) result = result * x % mod;
+			return result;
+		};
+		const size_t n = a.size();
+		for(size_t i=1, j=0; i<n; i++){
+			size_t bit = n >> 1;
+			for(; j & bit; bit >>= 1) j ^= bit;
+			j ^= bit;
+			if(i < j) std::swap(a[i], a[j]);
+		}
+		std::vector<unsigned int> w(n/2 + 1);
+		for(size_t l=2; l<=n; l<<=1){
+			unsigned long long wl = power(3, (mod-1) / l);
+			if(invert) wl = power(wl, mod-2);
+			w[0] = 1;
+			for(size_t i=1; i<l/2; i++) w[i] = (unsigned int)(w[i-1] * wl % mod);
+			for(size_t offset=0; offset<n; offset+=l){
+				unsigned int *front = &a[offset], *back = &a[offset+l/2];
+				for(size_t i=0; i<l/2; i++){
+					unsigned int x = front[i], y = (unsigned int)((unsigned long long)back[i] * w[i] % mod);
+					front[i] = (x + y >= mod ? x + y - mod : x + y);
+					back[i]  = (x >= y ? x - y : x + mod - y);
+				}
+			}
+		}
+		if(invert){
+			unsigned long long ninv = power(n % mod, mod-2);
+			for(auto &x: a) x = (unsigned int)(x * ninv % mod);
+		}
+	}
+
+	// Convolution of 32-bit pieces modulo one prime
+	template <unsigned int mod> static std::vector<unsigned int> convolutePieces(
+		const limb *a, size_t n, const limb *b, size_t m, size_t len){
+		auto split = [len](const limb *x, size_t cnt) -> std::vector<unsigned int>{
+			std::vector<unsigned int> pieces(len, 0);
+			for(size_t i=0; i<cnt; i++){
+				pieces[2*i]   = (unsigned int)((x[i] & 0xFFFFFFFFULL) % mod);
+				pieces[2*i+1] = (unsigned int)((x[i] >> 32) % mod);
+			} return pieces;
+		};
+		std::vector<unsigned int> pa = split(a, n), pb = split(b, m);
+		ntt<mod>(pa, false); ntt<mod>(pb, false);
+		for(size_t i=0; i<len; i++) pa[i] = (unsigned int)((unsigned long long)pa[i] * pb[i] % mod);
+		ntt<mod>(pa, true);
+		return pa;
+	}
+
+	// r[0, n+m) = a[0, n) * b[0, m) by three-prime NTT over 32-bit pieces and CRT.
+	// 998244353 has roots of unity only up to 2^23 points, so one transform covers
+	// n+m <= NTT_MAX_LIMBS; Longer products are cut into blocks that fit and summed.
+	// Each coefficient is then below 2^64 * 2^22, far under the product of primes (~2^86).
+	static void mulNTT(limb *r, const limb *a, size_t n, const limb *b, size_t m){
+		if(n + m > NTT_MAX_LIMBS){
+			const size_t blockB = std::min(m, NTT_MAX_LIMBS / 2), blockA = NTT_MAX_LIMBS - blockB;
+			std::fill(r, r+n+m, 0);
+			std::vector<limb> partial(NTT_MAX_LIMBS);
+			for(size_t i=0; i<n; i+=blockA) for(size_t j=0; j<m; j+=blockB){
+				size_t lenA = std::min(blockA, n-i), lenB = std::min(blockB, m-j);
+				mulNTT(partial.data(), a+i, lenA, b+j, lenB);
+				addLimbs(r+i+j, r+i+j, n+m-i-j, partial.data(), lenA+lenB);
+			} return;
+		}
+		const unsigned long long m0 = 998244353, m1 = 167772161, m2 = 469762049;
+		const size_t need = 2*(n+m);
+		size_t len = 1;
+		while(len < need) len <<= 1;
+		std::vector<unsigned int> c0 = convolutePieces<998244353>(a, n, b, m, len),
+		                          c1 = convolutePieces<167772161>(a, n, b, m, len),
+		                          c2 = convolutePieces<469762049>(a, n, b, m, len);
+
+		// Garner's CRT and carry propagation
+		const unsigned long long inv01 = 47450712; // m0^-1 mod m1
+		const unsigned long long inv012 = 115990628; // (m0 m1)^-1 mod m2
+		dlimb carry = 0;
+		for(size_t i=0; i<need; i++){
+			unsigned long long x0 = c0[i], x1 = c1[i], x2 = c2[i];
+			unsigned long long v1 = (x1 + m1 - x0 % m1) % m1 * inv01 % m1;
+			unsigned long long x01 = (x0 + m0 * v1) % m2; // Value mod m2 of x0 + m0 v1
+			unsigned long long v2 = (x2 + m2 - x01) % m2 * inv012 % m2;
+			carry += (dlimb)x0 + (dlimb)m0 * v1 + (dlimb)(m0 * m1) * v2;
+			unsigned long long piece = (unsigned long long)(carry & 0xFFFFFFFFULL);
+			if(i%2 == 0) r[i/2] = piece;
+			else r[i/2] |= piece << 32;
+			carry >>= 32;
+		}
+	}
+
+	// r[0, n+m) = a[0, n) * b[0, m); r must not overlap a or b.
+	static void multiplyLimbs(limb *r, const limb *a, size_t n, const limb *b, size_t m){
+		if(n < m){std::swap(a, b); std::swap(n, m);}
+		if(m == 0){std::fill(r, r+n, 0); return;}
+		if(m < KARATSUBA_THRESHOLD){mulSchoolbook(r, a, n, b, m); return;}
+		if(m >= NTT_THRESHOLD){mulNTT(r, a, n, b, m); return;}
+
+		// Unbalanced; Cut a into m-sized blocks
+		if(n >= 2*m){
+			std::fill(r, r+n+m, 0);
+			std::vector<limb> partial(2*m);
+			for(size_t offset=0; offset<n; offset+=m){
+				size_t len = std::min(m, n-offset);
+				multiplyLimbs(partial.data(), a+offset, len, b, m);
+				addLimbs(r+offset, r+offset, n+m-offset, partial.data(), len+m);
+			} return;
+		}
+		if(m >= TOOM3_THRESHOLD){mulToom3(r, a, n, b, m); return;}
+
+		// Balanced Karatsuba; Pad b up to n limbs
+		std::vector<limb> padded(b, b+m), product(2*n);
+		padded.resize(n, 0);
+		mulKaratsuba(product.data(), a, padded.data(), n);
+		std::copy(product.begin(), product.begin()+n+m, r);
+	}
+
+	// Exact or truncating division of magnitude by small number; Returns remainder.
+	limb divSmall(limb d){
+		limb rem = divSmallLimbs(limbs.data(), limbs.size(), d);
+		cleanBack(); return rem;
+	}
+
+	// Signed addition of (anotherSign, b) into this
+	void addSigned(bool anotherSign, const LimbStorage &b){
+		if(sign == anotherSign){
+			if(limbs.size() < b.size()) limbs.resize(b.size(), 0);
+			limb carry = addLimbs(limbs.data(), limbs.data(), limbs.size(), b.data(), b.size());
+			if(carry) limbs.push_back(carry);
+		}
+		else if(compareLimbs(limbs.data(), limbs.size(), b.data(), b.size()) >= 0){
+			subLimbs(limbs.data(), limbs.data(), limbs.size(), b.data(), b.size());
+		}
+		else{
+			limbs.resize(b.size(), 0);
+			subLimbs(limbs.data(), b.data(), b.size(), limbs.data(), limbs.size());
+			sign = anotherSign;
+		}
+		cleanBack();
+	}
+
+	// q[0, n-m+1) = a[0, n) / b[0, m), r[0, m) = a[0, n) % b[0, m) by Knuth's algorithm D.
+	// Requires n >= m >= 1 and b[m-1] != 0; q and r must not overlap a or b.
+	static void divmodLimbs(limb *q, limb *r, const limb *a, size_t n, const limb *b, size_t m){
+		if(m == 1){
+			std::copy(a, a+n, q);
+			r[0] = divSmallLimbs(q, n, b[0]);
+			return;
+		}
+
+		// Normalize so that top limb of divisor has its highest bit set
+		const int shift = __builtin_clzll(b[m-1]);
+		std::vector<limb> bn(m), an(n+1);
+		for(size_t i=0; i<m; i++) bn[i] = (b[i] << shift) | (shift && i ? b[i-1] >> (64-shift) : 0);
+		for(size_t i=0; i<n; i++) an[i] = (a[i] << shift) | (shift && i ? a[i-1] >> (64-shift) : 0);
+		an[n] = (shift ? a[n-1] >> (64-shift) : 0);
+
+		const limb top = bn[m-1], second = bn[m-2];
+		for(size_t j=n-m+1; j-->0;){
+
+			// Estimate quotient limb from top two limbs, then refine with the third
+			dlimb num = ((dlimb)an[j+m] << 64) | an[j+m-1];
+			dlimb qhat = num / top, rhat = num % top;
+			while((qhat >> 64) || qhat * second > ((rhat << 64) | an[j+m-2])){
+				qhat--; rhat += top;
+				if(rhat >> 64) break;
+			}
+
+			// an[j, j+m] -= qhat * bn, adding back once if it went negative
+			limb mulCarry = 0, borrow = 0;
+			for(size_t i=0; i<m; i++){
+				dlimb p = (dlimb)(limb)qhat * bn[i] + mulCarry;
+				mulCarry = (limb)(p >> 64);
+				limb x = an[i+j], y = (limb)p;
+				an[i+j] = x - y - borrow;
+				borrow = (x < y) || (x - y < borrow);
+			}
+			limb x = an[j+m];
+			an[j+m] = x - mulCarry - borrow;
+			if((x < mulCarry) || (x - mulCarry < borrow)){
+				qhat--;
+				an[j+m] += addLimbs(an.data()+j, an.data()+j, m, bn.data(), m);
+			}
+			q[j] = (limb)qhat;
+		}
+		for(size_t i=0; i<m; i++) r[i] = (an[i] >> shift) | (shift ? an[i+1] << (64-shift) : 0);
+	}
+
+	// Quotient and remainder of magnitudes |a| / |b|; Results are non-negative.
+	static void divmodAbs(const BigInt &a, const BigInt &b, BigInt &q, BigInt &r){
+		if(b.limbs.empty()) throw "Division by zero";
+		const size_t n = a.limbs.size(), m = b.limbs.size();
+		if(compareLimbs(a.limbs.data(), n, b.limbs.data(), m) < 0){
+			q = BigInt(0); r = a; r.sign = true;
+			return;
+		}
+		if(m >= NEWTON_DIVISION_THRESHOLD && n-m >= NEWTON_DIVISION_THRESHOLD){
+			divmodNewton(a, b, q, r);
+			return;
+		}
+		BigInt quotient, remainder;
+		quotient.limbs.resize(n-m+1); remainder.limbs.resize(m);
+		divmodLimbs(quotient.limbs.data(), remainder.limbs.data(), a.limbs.data(), n, b.limbs.data(), m);
+		quotient.cleanBack(); remainder.cleanBack();
+		q = quotient; r = remainder;
+	}
+
+	// this * B^k and this / B^k (truncated), keeping sign
+	BigInt shiftedLeft(size_t k) const{
+		if(limbs.empty()) return *this;
+		BigInt result;
+		result.limbs.resize(limbs.size() + k, 0);
+		std::copy(limbs.data(), limbs.data() + limbs.size(), result.limbs.data() + k);
+		result.sign = sign;
+		return result;
+	}
+	BigInt shiftedRight(size_t k) const{
+		if(k >= limbs.size()) return BigInt(0);
+		BigInt result = fromLimbs(limbs.data() + k, limbs.size() - k);
+		if(!result.limbs.empty()) result.sign = sign;
+		return result;
+	}
+
+	// (|this| >> shift) truncated to 64 bits
+	limb bitsFrom(size_t shift) const{
+		const size_t index = shift / 64, offset = shift % 64;
+		limb low = (index < limbs.size() ? limbs[index] >> offset : 0);
+		limb high = (offset && index+1 < limbs.size() ? limbs[index+1] << (64-offset) : 0);
+		return low | high;
+	}
+
+	// floor(B^(2s) / p) where p > 0 has s limbs, by Newton iteration on the upper half.
+	static BigInt reciprocal(const BigInt &p){
+		const size_t s = p.limbs.size();
+		if(s <= 2*KARATSUBA_THRESHOLD){ // Direct long division
+			BigInt power = BigInt(1).shiftedLeft(2*s), q;
+			std::vector<limb> r(s);
+			q.limbs.resize(s+2);
+			divmodLimbs(q.limbs.data(), r.data(), power.limbs.data(), 2*s+1, p.limbs.data(), s);
+			q.cleanBack();
+			return q;
+		}
+
+		// Reciprocal of top h limbs gives about h correct limbs,
+		// one Newton step x += x(B^2s - px) / B^2s doubles that.
+		const size_t h = s/2 + 2;
+		BigInt x = reciprocal(p.shiftedRight(s-h)).shiftedLeft(s-h);
+		BigInt error = BigInt(1).shiftedLeft(2*s) - p * x;
+		x += (x * error).shiftedRight(2*s);
+
+		// Fix remaining off-by-few
+		error = BigInt(1).shiftedLeft(2*s) - p * x;
+		while(!error.sign){x -= BigInt(1); error += p;}
+		while(error >= p){x += BigInt(1); error -= p;}
+		return x;
+	}
+
+	// q = x / p, r = x % p for 0 <= x < B^(2s) where p > 0 has s limbs and inv = reciprocal(p)
+	static void divmodByReciprocal(const BigInt &x, const BigInt &p, const BigInt &inv, BigInt &q, BigInt &r){
+		q = (x * inv).shiftedRight(2 * p.limbs.size());
+		r = x - q * p;
+		while(!r.sign){q -= BigInt(1); r += p;}
+		while(r >= p){q += BigInt(1); r -= p;}
+	}
+
+	// Newton division of |a| by |b|: Schoolbook over base B^m digits of a
+	// where each digit step is one multiplication by reciprocal of b.
+	static void divmodNewton(const BigInt &a, const BigInt &b, BigInt &q, BigInt &r){
+		const size_t n = a.limbs.size(), m = b.limbs.size();
+		BigInt divisor = fromLimbs(b.limbs.data(), m), inv = reciprocal(divisor);
+		BigInt quotient, remainder, digit;
+		quotient.limbs.resize(n, 0);
+		for(size_t offset = (n-1) / m * m; ; offset -= m){
+			BigInt x = remainder.shiftedLeft(m) + fromLimbs(a.limbs.data() + offset, std::min(m, n-offset));
+			divmodByReciprocal(x, divisor, inv, digit, remainder);
+			std::copy(digit.limbs.data(), digit.limbs.data() + digit.limbs.size(), quotient.limbs.data() + offset);
+			if(offset == 0) break;
+		}
+		quotient.cleanBack();
+		q = std::move(quotient); r = std::move(remainder);
+	}
+
+	// Montgomery multiplication context for odd modulus of s limbs
+	class Montgomery{
+	public:
+		size_t s;
+		std::vector<limb> mod, scratch;
+		limb inv; // -mod^-1 mod 2^64
+
+		Montgomery(const BigInt &m): s(m.limbs.size()), mod(m.limbs.data(), m.limbs.data() + s), scratch(s+2){
+			limb x = 1; // Newton iteration for mod[0]^-1 mod 2^64
+			for(int i=0; i<6; i++) x *= 2 - mod[0] * x;
+			inv = -x;
+		}
+
+		// r[0, s) = a * b / B^s mod m by CIOS; r may alias a or b.
+		void multiply(limb *r, const limb *a, const limb *b){
+			limb *t = scratch.data();
+			std::fill(t, t+s+2, 0);
+			for(size_t i=0; i<s; i++){
+				limb carry = 0;
+				for(size_t j=0; j<s; j++){
+					dlimb p = (dlimb)a[j] * b[i] + t[j] + carry;
+					t[j] = (limb)p; carry = (limb)(p >> 64);
+				}
+				dlimb top = (dlimb)t[s] + carry;
+				t[s] = (limb)top; t[s+1] = (limb)(top >> 64);
+
+				limb factor = t[0] * inv;
+				carry = (limb)(((dlimb)factor * mod[0] + t[0]) >> 64);
+				for(size_t j=1; j<s; j++){
+					dlimb p = (dlimb)factor * mod[j] + t[j] + carry;
+					t[j-1] = (limb)p; carry = (limb)(p >> 64);
+				}
+				top = (dlimb)t[s] + carry;
+				t[s-1] = (limb)top; t[s] = t[s+1] + (limb)(top >> 64);
+			}
+			if(t[s] || compareLimbs(t, s, mod.data(), s) >= 0) subLimbs(t, t, s, mod.data(), s);
+			std::copy(t, t+s, r);
+		}
+	};
+
+	// ----------------------------------------------------------------------------------
+	// Radix conversion helpers
+
+	// Up to 19 * 2^CONVERSION_BASE_LEVEL digits are converted in quadratic time.
+	static const size_t CONVERSION_BASE_LEVEL = 5;
+
+	// Cached 10^(19 * 2^k) and their reciprocals
+	static const BigInt& powerOfTen(size_t k){
+		static std::vector<BigInt> powers;
+		if(powers.empty()) powers.push_back(BigInt(10000000000000000000ULL));
+		while(powers.size() <= k) powers.push_back(powers.back() * powers.back());
+		return powers[k];
+	}
+	static const BigInt& reciprocalOfPowerOfTen(size_t k){
+		static std::vector<BigInt> reciprocals;
+		while(reciprocals.size() <= k) reciprocals.push_back(reciprocal(powerOfTen(reciprocals.size())));
+		return reciprocals[k];
 	}
-	
+
+	// q = x / 10^(19 * 2^k), r = x % 10^(19 * 2^k) for 0 <= x < 10^(19 * 2^(k+1))
+	static void divmodPowerOfTen(const BigInt &x, size_t k, BigInt &q, BigInt &r){
+		divmodByReciprocal(x, powerOfTen(k), reciprocalOfPowerOfTen(k), q, r);
+	}
+
+	// Parse digits[0, len) as non-negative number
+	static BigInt parseDigits(const char *digits, size_t len){
+		if(len <= (19u << CONVERSION_BASE_LEVEL)){ // Feed 19 decimal digits at once
+			BigInt result;
+			const size_t head = len % 19;
+			for(size_t i=0, chunk = (head ? head : 19); i < len; i += chunk, chunk = 19){
+				limb value = 0, scale = 1;
+				for(size_t j=0; j<chunk; j++) value = value * 10 + (digits[i+j] - '0'), scale *= 10;
+				limb carry = mulSmallLimbs(result.limbs.data(), result.limbs.size(), scale, value);
+				if(carry) result.limbs.push_back(carry);
+			}
+			result.cleanBack();
+			return result;
+		}
+
+		// high * 10^lowlen + low where lowlen = 19 * 2^k is largest below len
+		size_t k = 0;
+		while((19u << (k+1)) < len) k++;
+		const size_t lowlen = 19u << k;
+		BigInt result = parseDigits(digits, len - lowlen) * powerOfTen(k);
+		result += parseDigits(digits + len - lowlen, lowlen);
+		return result;
+	}
+
+	// Append decimal representation of 0 <= x < 10^(19 * 2^k),
+	// left-padded with zeros to exactly 19 * 2^k digits if pad is true.
+	static void formatDigits(const BigInt &x, size_t k, bool pad, std::string &out){
+		if(k <= CONVERSION_BASE_LEVEL){ // Peel 19 decimal digits at once
+			std::vector<limb> chunks; // Base 10^19, lower first
+			std::vector<limb> copied(x.limbs.data(), x.limbs.data() + x.limbs.size());
+			size_t len = copied.size();
+			while(len > 0){
+				chunks.push_back(divSmallLimbs(copied.data(), len, 10000000000000000000ULL));
+				while(len > 0 && copied[len-1] == 0) len--;
+			}
+			if(pad) chunks.resize((size_t)1 << k, 0);
+			else if(chunks.empty()){out += '0'; return;}
+			char buffer[24];
+			for(size_t i=chunks.size(); i-->0;){
+				snprintf(buffer, sizeof(buffer), (pad || i+1 < chunks.size()) ? "%019llu" : "%llu", chunks[i]);
+				out += buffer;
+			} return;
+		}
+		BigInt q, r;
+		divmodPowerOfTen(x, k-1, q, r);
+		if(!pad && q.limbs.empty()) formatDigits(r, k-1, false, out);
+		else{
+			formatDigits(q, k-1, pad, out);
+			formatDigits(r, k-1, true, out);
+		}
+	}
+
 public:
-	
+
 	// ----------------------------------------------------------------------------------
 	// Constructors
-	
+
 	// Constructor by int
-	BigInt(int x = 0){*this = BigInt((long long int)x);}
+	BigInt(int x = 0): BigInt((long long int)x){}
 	BigInt(long long int x){
-		if(x>=0) sign = true;
-		else x *= -1, sign = false;
-		digits.clear();
-		while(x>0){
-			digits.push_back(x % onesize);
-			x /= onesize;
-		} cleanBack();
-	}
-	
-	// Constructor by string
-	BigInt(const char* &line){*this = BigInt(std::string(line));}
-	BigInt(std::string line){
-		if(line[0] == '+' || ('0' <= line[0] && line[0] <= '9')) sign = true;
-		else sign = false;
-		digits.clear();
-		while(!line.empty() && line != "+" && line != "-"){
-			int num = 0, scale = 1;
-			for(int i=0; i<4 && !line.empty(); i++){
-				if(line == "+" || line == "-") break;
-				else if(line.back() < '0' || '9' < line.back()) throw "Non-number found";
-				num += (line.back() - '0') * scale;
-				scale *= 10;
-				line.pop_back();
-			}
-			digits.push_back(num);
-		} cleanBack();
-	}
-	
-	// Constructor by BigInt
-	BigInt(const BigInt &another){
-		*this = another;
-		cleanBack();
+		sign = (x >= 0);
+		unsigned long long int magnitude = sign ? (unsigned long long int)x : -(unsigned long long int)x;
+		if(magnitude > 0) limbs.push_back(magnitude);
+	}
+	BigInt(unsigned long long int x){
+		sign = true;
+		if(x > 0) limbs.push_back(x);
+	}
+
+	// Constructor by string; Divide and conquer over cached powers of 10.
+	BigInt(const char* line): BigInt(std::string(line)){}
+	BigInt(const std::string &line){
+		size_t start = 0;
+		if(!line.empty() && (line[0] == '+' || line[0] == '-')) start = 1;
+		for(size_t i=start; i<line.size(); i++)
+			if(line[i] < '0' || '9' < line[i]) throw "Non-number found";
+		*this = parseDigits(line.data() + start, line.size() - start);
+		if(!limbs.empty()) sign = (start == 0 || line[0] == '+');
 	}
 
 	// ----------------------------------------------------------------------------------
-	// String representation
-	std::string str(){
-		if(digits.empty()) return "0";
-		std::string result = std::to_string(digits.back());
-		for(int i=(int)digits.size()-2; i >= 0; i--){
-			for(int j = onesize/10; j>0; j/=10) result += (digits[i] / j % 10) + '0';
-		} return (sign ? '+':'-') + result;
-	}
-	
+	// String representation; Divide and conquer over cached powers of 10.
+	std::string str() const{
+		if(limbs.empty()) return "0";
+		BigInt magnitude(*this); magnitude.sign = true;
+		size_t k = 0;
+		while(powerOfTen(k) <= magnitude) k++;
+		std::string result(1, sign ? '+':'-');
+		formatDigits(magnitude, k, false, result);
+		return result;
+	}
+
 	// ----------------------------------------------------------------------------------
-	// Comparing operators: It can be optimized even more, but I don't implemented it yet.
-	
-	bool operator == (const BigInt &another){ // this == another ?
-		if(digits.empty() && another.digits.empty()) return true;
-		else if(sign != another.sign || digits.size() != another.digits.size()) return false;
-		for(int i=0; i<(int)digits.size(); i++) if(digits[i] != another.digits[i]) return false;
-		return true;
-	}
-	bool operator != (const BigInt &another){return !(this->operator ==(another));}
-	bool operator > (const BigInt &another){ // this > another ?
+	// Comparing operators
+
+	bool operator == (const BigInt &another) const{ // this == another ?
+		return sign == another.sign && limbs == another.limbs;
+	}
+	bool operator != (const BigInt &another) const{return !(this->operator ==(another));}
+	bool operator > (const BigInt &another) const{ // this > another ?
 		if(sign != another.sign) return sign; // this < 0 <= another (sign = false) || another < 0 <= this (sign = true)
-		else if(digits.size() > another.digits.size()) return sign; // abs(this) > abs(another)
-		else if(digits.size() < another.digits.size()) return !sign; // abs(this) < abs(another)
-		for(int i=(int)digits.size()-1; i>=0; i--){
-			if(digits[i] > another.digits[i]) return sign; // abs(this) > abs(another)
-			else if(digits[i] < another.digits[i]) return !sign; // abs(another) > abs(this)
-		} return false; // Absolute same
-	}
-	bool operator >= (const BigInt &another){return this->operator ==(another) || this->operator >(another);}
-	bool operator < (const BigInt &another){return !(this->operator >=(another));}
-	bool operator <= (const BigInt &another){return !(this->operator >(another));}
-	
+		int cmp = compareLimbs(limbs.data(), limbs.size(), another.limbs.data(), another.limbs.size());
+		return sign ? (cmp > 0) : (cmp < 0);
+	}
+	bool operator >= (const BigInt &another) const{return this->operator ==(another) || this->operator >(another);}
+	bool operator < (const BigInt &another) const{return !(this->operator >=(another));}
+	bool operator <= (const BigInt &another) const{return !(this->operator >(another));}
+
 	// ----------------------------------------------------------------------------------
 	// Arithmetic operator
-	
+
 	BigInt operator -() const{ // return -x
-		BigInt result(*this); result.sign = !(result.sign);
+		BigInt result(*this);
+		if(!result.limbs.empty()) result.sign = !(result.sign);
 		return result;
 	}
 	BigInt operator +() const {return *this;} // return +a (= a)
-	
-	BigInt operator +(const BigInt &another){ // return this + another
-		if(sign != another.sign) return this->operator -(-another);
-		BigInt result(0);
-		int maxdigitsize = (digits.size() > another.digits.size() ? digits.size() : another.digits.size());
-		result.digits = std::vector<int>(0, maxdigitsize + 1);
-		for(int i=0; i < maxdigitsize; i++){
-			if(i < (int)digits.size()) result.digits[i] += digits[i];
-			if(i < (int)another.digits.size()) result.digits[i] += another.digits[i];
-			result.digits[i+1] += result.digits[i] / onesize;
-			result.digits[i] %= onesize;
-		} result.cleanBack();
-		return result;
+
+	BigInt& operator +=(const BigInt &another){ // this += another
+		addSigned(another.sign, another.limbs); // Safe for this == &another
+		return *this;
+	}
+	BigInt& operator -=(const BigInt &another){ // this -= another
+		if(this == &another){limbs.clear(); sign = true; return *this;}
+		addSigned(another.limbs.empty() || !another.sign, another.limbs);
+		return *this;
+	}
+	BigInt& operator *=(const BigInt &another){ // this *= another
+		if(limbs.empty() || another.limbs.empty()){limbs.clear(); sign = true; return *this;}
+		const size_t n = limbs.size(), m = another.limbs.size();
+		if(n + m <= 8){ // Small product on stack; Stays inline if trimmed result fits
+			limb product[8];
+			mulSchoolbook(product, limbs.data(), n, another.limbs.data(), m);
+			size_t len = n + m;
+			while(len > 0 && product[len-1] == 0) len--;
+			limbs.resize(len);
+			std::copy(product, product + len, limbs.data());
+		}
+		else{
+			LimbStorage product;
+			product.resize(n + m);
+			multiplyLimbs(product.data(), limbs.data(), n, another.limbs.data(), m);
+			limbs = std::move(product);
+		}
+		sign = (sign == another.sign);
+		cleanBack();
+		return *this;
 	}
-	BigInt operator -(const BigInt &another){ // return this - another
-		if(sign != another.sign) return this->operator +(-another);
+
+	// Left operand by value so temporaries are moved in and reused
+	friend BigInt operator +(BigInt a, const BigInt &b){a += b; return a;}
+	friend BigInt operator -(BigInt a, const BigInt &b){a -= b; return a;}
+	friend BigInt operator *(BigInt a, const BigInt &b){a *= b; return a;}
+
+	// ----------------------------------------------------------------------------------
+	// Division and powers
+
+	// Quotient truncated toward zero and remainder with sign of a, like built-in integers.
+	static void divmod(const BigInt &a, const BigInt &b, BigInt &q, BigInt &r){
+		BigInt quotient, remainder;
+		divmodAbs(a, b, quotient, remainder);
+		if(!quotient.limbs.empty()) quotient.sign = (a.sign == b.sign);
+		if(!remainder.limbs.empty()) remainder.sign = a.sign;
+		q = std::move(quotient); r = std::move(remainder);
+	}
+	BigInt& operator /=(const BigInt &another){BigInt r; divmod(*this, another, *this, r); return *this;}
+	BigInt& operator %=(const BigInt &another){BigInt q; divmod(*this, another, q, *this); return *this;}
+	friend BigInt operator /(BigInt a, const BigInt &b){a /= b; return a;}
+	friend BigInt operator %(BigInt a, const BigInt &b){a %= b; return a;}
+
+	// Number of bits in magnitude, and single bit of magnitude
+	size_t bitLength() const{
+		return limbs.empty() ? 0 : 64 * limbs.size() - __builtin_clzll(limbs.back());
+	}
+	bool bit(size_t index) const{
+		return index / 64 < limbs.size() && ((limbs[index / 64] >> (index % 64)) & 1);
+	}
+
+	// Greatest common divisor of |a| and |b| by Lehmer's algorithm;
+	// Euclid steps are simulated on leading 62 bits and applied as one cofactor update.
+	static BigInt gcd(BigInt a, BigInt b){
+		a.sign = true, b.sign = true;
+		if(a < b) std::swap(a, b);
+		while(b.limbs.size() > 1){
+			const size_t shift = a.bitLength() - 62;
+			long long x = (long long)a.bitsFrom(shift), y = (long long)b.bitsFrom(shift);
+			long long A = 1, B = 0, C = 0, D = 1;
+			while(y + C != 0 && y + D != 0){
+				long long q = (x + A) / (y + C);
+				if(q != (x + B) / (y + D)) break;
+				long long t;
+				t = (long long)(A - (__int128)q * C); A = C; C = t;
+				t = (long long)(B - (__int128)q * D); B = D; D = t;
+				t = x - q * y; x = y; y = t;
+			}
+			if(B == 0){ // Leading bits gave no information; Full division step
+				BigInt r = a % b;
+				a = std::move(b); b = std::move(r);
+			}
+			else{
+				BigInt na = BigInt(A) * a + BigInt(B) * b, nb = BigInt(C) * a + BigInt(D) * b;
+				a = std::move(na); b = std::move(nb);
+			}
+			if(a < b) std::swap(a, b);
+		}
+		if(b.limbs.empty()) return a;
+
+		// Single limb; Binary GCD on machine words
+		BigInt r = a % b;
+		limb x = (r.limbs.empty() ? 0 : r.limbs[0]), y = b.limbs[0];
+		if(x == 0) return b;
+		const int shift = __builtin_ctzll(x | y);
+		x >>= __builtin_ctzll(x);
+		do{
+			y >>= __builtin_ctzll(y);
+			if(x > y) std::swap(x, y);
+			y -= x;
+		} while(y != 0);
+		return BigInt(x << shift);
+	}
+
+	// base^exponent
+	static BigInt pow(BigInt base, unsigned long long int exponent){
+		BigInt result(1);
+		for(; exponent > 0; exponent >>= 1){
+			if(exponent & 1) result *= base;
+			if(exponent > 1) base *= base;
+		} return result;
+	}
+
+	// base^exponent mod m in [0, m) by sliding window exponentiation.
+	// Montgomery multiplication is used for odd m, plain remainders otherwise.
+	static BigInt modpow(BigInt base, BigInt exponent, BigInt mod){
+		if(mod.limbs.empty() || !mod.sign) throw "Modulus should be positive";
+		if(!exponent.sign) throw "Negative exponent";
+		base %= mod;
+		if(!base.sign) base += mod;
+		if(mod == BigInt(1)) return BigInt(0);
+
+		// Window size by exponent length; Table keeps odd powers g^1, g^3, ..., g^(2^w - 1)
+		const size_t bits = exponent.bitLength();
+		const int window = bits > 1024 ? 6 : bits > 256 ? 5 : bits > 64 ? 4 : bits > 16 ? 3 : 1;
+		const size_t tableSize = (size_t)1 << (window-1);
+
+		if(mod.limbs[0] & 1){
+			Montgomery context(mod);
+			const size_t s = context.s;
+			auto toMontgomery = [&](const BigInt &x) -> std::vector<limb>{
+				BigInt converted = x.shiftedLeft(s) % mod;
+				std::vector<limb> result(s, 0);
+				std::copy(converted.limbs.data(), converted.limbs.data() + converted.limbs.size(), result.data());
+				return result;
+			};
+			std::vector<std::vector<limb>> table(tableSize);
+			table[0] = toMontgomery(base);
+			std::vector<limb> square(table[0]), result = toMontgomery(BigInt(1));
+			context.multiply(square.data(), square.data(), square.data());
+			for(size_t i=1; i<tableSize; i++){
+				table[i].resize(s);
+				context.multiply(table[i].data(), table[i-1].data(), square.data());
+			}
+			for(size_t i=bits; i-->0;){
+				if(!exponent.bit(i)){
+					context.multiply(result.data(), result.data(), result.data());
+					continue;
+				}
+				size_t low = (i+1 >= (size_t)window ? i+1-window : 0);
+				while(!exponent.bit(low)) low++;
+				size_t value = 0;
+				for(size_t j=i+1; j-->low;){
+					value = value << 1 | exponent.bit(j);
+					context.multiply(result.data(), result.data(), result.data());
+				}
+				context.multiply(result.data(), result.data(), table[value >> 1].data());
+				i = low;
+			}
+			std::vector<limb> one(s, 0); one[0] = 1;
+			context.multiply(result.data(), result.data(), one.data());
+			BigInt answer = fromLimbs(result.data(), s);
+			return answer;
+		}
+
+		// Even modulus
+		std::vector<BigInt> table(tableSize);
+		table[0] = base;
+		BigInt square = base * base % mod, result(1);
+		for(size_t i=1; i<tableSize; i++) table[i] = table[i-1] * square % mod;
+		for(size_t i=bits; i-->0;){
+			if(!exponent.bit(i)){
+				result = result * result % mod;
+				continue;
+			}
+			size_t low = (i+1 >= (size_t)window ? i+1-window : 0);
+			while(!exponent.bit(low)) low++;
+			size_t value = 0;
+			for(size_t j=i+1; j-->low;){
+				value = value << 1 | exponent.bit(j);
+				result = result * result % mod;
+			}
+			result = result * table[value >> 1] % mod;
+			i = low;
+		} return result;
 	}
 };
 
+#ifdef __McDic_benchmark__ // Modular exponentiation throughput
+#include <chrono>
+#include <random>
+void benchmarkModpow(){
+	std::mt19937_64 mersenne_twister(42);
+	auto randomBits = [&](size_t bits) -> BigInt{
+		BigInt x(1);
+		for(size_t i=1; i<bits; i++) x = x * BigInt(2) + BigInt((int)(mersenne_twister() & 1));
+		return x;
+	};
+	for(size_t bits: {1024, 2048, 4096}){
+		BigInt mod = randomBits(bits-1) * BigInt(2) + BigInt(1), base = randomBits(bits-1), exponent = randomBits(bits);
+		int repeat = 0;
+		auto start = std::chrono::steady_clock::now();
+		std::chrono::duration<double> elapsed;
+		do{
+			BigInt::modpow(base, exponent, mod); repeat++;
+			elapsed = std::chrono::steady_clock::now() - start;
+		} while(elapsed.count() < 1.0);
+		printf("%4zu bits: %.3f ms per modpow, %.1f per second\n",
+			bits, 1000 * elapsed.count() / repeat, repeat / elapsed.count());
+	}
+}
+#endif
+
 int main(void){
-	
+#ifdef __McDic_benchmark__
+	benchmarkModpow();
+	return 0;
+#endif
+
 	BigInt a("1725543529834737");
 	BigInt b("941515007841");
 	std::cout << a.str() << " == " << b.str() << " = " << (a==b ? "TRUE":"FALSE") << std::endl;
 	std::cout << a.str() << " > " << b.str() << " = " << (a>b ? "TRUE":"FALSE") << std::endl;
 	std::cout << a.str() << " < " << b.str() << " = " << (a<b ? "TRUE":"FALSE") << std::endl;
+	std::cout << a.str() << " + " << b.str() << " = " << (a+b).str() << std::endl;
+	std::cout << a.str() << " - " << b.str() << " = " << (a-b).str() << std::endl;
+	std::cout << b.str() << " - " << a.str() << " = " << (b-a).str() << std::endl;
+	std::cout << a.str() << " * " << b.str() << " = " << (a*b).str() << std::endl;
+	std::cout << a.str() << " / " << b.str() << " = " << (a/b).str() << std::endl;
+	std::cout << a.str() << " % " << b.str() << " = " << (a%b).str() << std::endl;
+	std::cout << "modpow(" << a.str() << ", " << b.str() << ", 10^9+7) = "
+		<< BigInt::modpow(a, b, BigInt(1000000007)).str() << std::endl;
 	return 0;
 }
@@ -5,36 +5,290 @@
 
 #include <stdio.h>
 #include <assert.h>
+#include <math.h>
 #include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <tuple>
+#include "prime_table_mmap.h"
+#include "thread_pool.h"
 
 // Attributes
 typedef long long int lld;
-std::vector<bool> isPrime;
-std::vector<int> primes;
+typedef unsigned long long int llu;
+
+// Multiplicative functions for MultiplicativeSieve.
+// Each gives f(p^e) for prime power pe = p^e; Other values follow from f(ab) = f(a)f(b) for coprime a, b.
+struct EulerPhi{
+	typedef int value;
+	static value atPrimePower(int p, int, int pe){return pe - pe / p;}
+};
+struct Mobius{
+	typedef signed char value;
+	static value atPrimePower(int, int e, int){return e == 1 ? -1 : 0;}
+};
+struct DivisorCount{
+	typedef int value;
+	static value atPrimePower(int, int e, int){return e + 1;}
+};
+struct DivisorSum{
+	typedef lld value;
+	static value atPrimePower(int p, int, int pe){return ((lld)pe * p - 1) / (p - 1);}
+};
+
+// Position of Policy in Policies...; Tuple access by type needs C++14, so tables are found by index.
+template <typename Policy, typename First, typename... Rest> struct PolicyIndex{
+	static const size_t value = 1 + PolicyIndex<Policy, Rest...>::value;
+};
+template <typename Policy, typename... Rest> struct PolicyIndex<Policy, Policy, Rest...>{
+	static const size_t value = 0;
+};
+
+// Linear sieve filling f(1..n) for every policy in one pass, one array per function.
+// lowPower[m] is the largest power of the smallest prime dividing m, so m = lowPower[m] * rest
+// with coprime parts and f(m) = f(rest) * f(lowPower[m]) needs no factorization.
+template <typename... Policies> class MultiplicativeSieve{
+public:
+	template <typename Policy> struct Table{std::vector<typename Policy::value> values;};
+	std::vector<int> primes, lowPower;
+	std::vector<unsigned char> exponent;
+	std::tuple<Table<Policies>...> tables;
+
+	template <typename Policy> Table<Policy> &tableOf(){
+		return std::get<PolicyIndex<Policy, Policies...>::value>(tables);}
+	template <typename Policy> const Table<Policy> &tableOf() const{
+		return std::get<PolicyIndex<Policy, Policies...>::value>(tables);}
+
+	MultiplicativeSieve(int n): lowPower(n+1, 0), exponent(n+1, 0){
+		// Expanding into a dummy array runs the statement once per policy
+		int expand[] = {(tableOf<Policies>().values.assign(n+1, 1), 0)...}; (void)expand;
+		for(int i=2; i<=n; i++){
+			if(lowPower[i] == 0){
+				primes.push_back(i);
+				lowPower[i] = i, exponent[i] = 1;
+				int fill[] = {(at<Policies>(i) = Policies::atPrimePower(i, 1, i), 0)...}; (void)fill;
+			}
+			for(size_t j=0; j<primes.size() && (lld)i * primes[j] <= (lld)n; j++){
+				const int p = primes[j], m = i * p;
+				if(i % p != 0){ // p is new smallest prime of m
+					lowPower[m] = p, exponent[m] = 1;
+					int fill[] = {(at<Policies>(m) = at<Policies>(i) * at<Policies>(p), 0)...}; (void)fill;
+				}
+				else{ // p is smallest prime of i too; Raise its power
+					lowPower[m] = lowPower[i] * p, exponent[m] = exponent[i] + 1;
+					const int rest = i / lowPower[i];
+					if(rest == 1){int fill[] = {(at<Policies>(m) = Policies::atPrimePower(p, exponent[m], m), 0)...}; (void)fill;}
+					else{int fill[] = {(at<Policies>(m) = at<Policies>(rest) * at<Policies>(lowPower[m]), 0)...}; (void)fill;}
+					break;
+				}
+			}
+		}
+	}
+
+	// f(m) for given policy
+	template <typename Policy> typename Policy::value &at(int m){return tableOf<Policy>().values[m];}
+	template <typename Policy> const std::vector<typename Policy::value> &table() const{
+		return tableOf<Policy>().values;
+	}
+};
+
+// Segmented sieve on mod 30 wheel.
+// Each byte covers 30 consecutive numbers, one bit per residue coprime to 30,
+// and segments are sized to stay in L1 cache. Memory is O(sqrt(hi)) for base primes.
+namespace WheelSieve{
+
+	const int SEGMENT_BYTES = 32768; // Covers 30 * 32768 numbers per segment
+	const int wheel[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+	const int gap[8] = {6, 4, 2, 4, 2, 4, 6, 2}; // wheel[i+1] - wheel[i], cyclic
+
+	// For prime residue index i and multiplier residue index j:
+	// crossMask[i][j] is bit of residue wheel[i] * wheel[j] mod 30, and
+	// crossCarry[i][j] is extra byte step when multiplier advances by gap[j].
+	struct Tables{
+		int bitOfResidue[30];
+		unsigned char crossMask[8][8], crossCarry[8][8];
+		Tables(){
+			for(int r=0; r<30; r++) bitOfResidue[r] = -1;
+			for(int k=0; k<8; k++) bitOfResidue[wheel[k]] = k;
+			for(int i=0; i<8; i++) for(int j=0; j<8; j++){
+				int r = wheel[i] * wheel[j] % 30;
+				crossMask[i][j] = (unsigned char)(1 << bitOfResidue[r]);
+				crossCarry[i][j] = (unsigned char)((r + wheel[i] * gap[j]) / 30);
+			}
+		}
+	};
+	const Tables tables;
+
+	// Table file from prime_table_mmap.cpp; Ranges below its limit are read from it instead of sieved.
+	PrimeTable table;
+	bool openTable(const char *path){return table.open(path);}
+	bool tableCovers(llu hi){return table.isOpen() && hi < table.limit();}
+	const uint32_t *tableBegin(){return table.primeData();}
+	const uint32_t *tableEnd(){return table.primeData() + table.primeCount();}
+
+	// floor(sqrt(x))
+	llu isqrt(llu x){
+		llu r = (llu)sqrtl((long double)x);
+		while(r * r > x) r--;
+		while((r+1) * (r+1) <= x) r++;
+		return r;
+	}
+
+	// Primes p with 7 <= p <= limit by plain sieve
+	std::vector<llu> basePrimes(llu limit){
+		if(tableCovers(limit)) return std::vector<llu>(std::lower_bound(tableBegin(), tableEnd(), 7U),
+			std::upper_bound(tableBegin(), tableEnd(), (uint32_t)limit));
+		std::vector<llu> result;
+		std::vector<char> composite(limit+1, 0);
+		for(llu i=2; i<=limit; i++){
+			if(composite[i]) continue;
+			if(i >= 7) result.push_back(i);
+			for(llu j=i*i; j<=limit; j+=i) composite[j] = 1;
+		}
+		return result;
+	}
+
+	// Sieve bytes covering [lo, hi] and call visit(bits, firstByte, byteCount) per segment.
+	// Bit k of byte b is set iff 30b + wheel[k] is prime and in [lo, hi]; 2, 3, 5 are not included.
+	// primes should contain basePrimes(isqrt(hi)) and is only read, so threads can share it.
+	template <typename Visitor> void sieveRange(llu lo, llu hi, const std::vector<llu> &primes, Visitor visit){
+		if(lo > hi) return;
+		const llu byteLo = lo / 30, byteHi = hi / 30;
+
+		// State of each base prime: Absolute byte of next multiple and residue index of multiplier
+		std::vector<llu> nextByte(primes.size());
+		std::vector<unsigned char> multiplierIndex(primes.size()), primeIndex(primes.size());
+		for(size_t i=0; i<primes.size(); i++){
+			const llu p = primes[i];
+			llu m = std::max(p, (lo + p - 1) / p); // First multiplier coprime to 30 from here
+			while(tables.bitOfResidue[m % 30] < 0) m++;
+			nextByte[i] = p * m / 30;
+			multiplierIndex[i] = (unsigned char)tables.bitOfResidue[m % 30];
+			primeIndex[i] = (unsigned char)tables.bitOfResidue[p % 30];
+		}
+
+		std::vector<unsigned char> segment(SEGMENT_BYTES);
+		size_t active = 0; // Primes with p^2 inside processed area
+		for(llu segLow = byteLo; segLow <= byteHi; segLow += SEGMENT_BYTES){
+			const llu segHigh = std::min(segLow + SEGMENT_BYTES, byteHi + 1);
+			const size_t count = segHigh - segLow;
+			std::fill(segment.begin(), segment.begin() + count, 0xFF);
+			while(active < primes.size() && primes[active] * primes[active] < 30 * segHigh) active++;
+
+			// Cross multiples p * m for m coprime to 30
+			for(size_t i=0; i<active; i++){
+				const llu stride = primes[i] / 30;
+				const int pi = primeIndex[i];
+				llu byte = nextByte[i];
+				int mi = multiplierIndex[i];
+				while(byte < segHigh){
+					segment[byte - segLow] &= (unsigned char)~tables.crossMask[pi][mi];
+					byte += stride * gap[mi] + tables.crossCarry[pi][mi];
+					mi = (mi + 1) & 7;
+				}
+				nextByte[i] = byte, multiplierIndex[i] = (unsigned char)mi;
+			}
+
+			// 1 is not prime, and trim numbers outside [lo, hi]
+			if(segLow == 0) segment[0] &= (unsigned char)~1;
+			for(int k=0; k<8; k++){
+				if(segLow == byteLo && 30 * byteLo + wheel[k] < lo) segment[0] &= (unsigned char)~(1 << k);
+				if(segHigh == byteHi + 1 && 30 * byteHi + wheel[k] > hi) segment[count-1] &= (unsigned char)~(1 << k);
+			}
+			visit(segment.data(), segLow, count);
+		}
+	}
+
+	// Numbers per work unit of parallel sieve; base prime states are rebuilt once per unit.
+	const llu CHUNK_NUMBERS = 30ULL * SEGMENT_BYTES * 64;
+
+	// Split [lo, hi] into chunks and sieve them on `threads` pooled workers pulling from a shared counter.
+	// visit(worker, bits, firstByte, byteCount) is called from worker threads.
+	template <typename Visitor> void parallelSieveRange(llu lo, llu hi, unsigned int threads, Visitor visit){
+		if(lo > hi) return;
+		const std::vector<llu> primes = basePrimes(isqrt(hi));
+		const llu chunks = (hi - lo) / CHUNK_NUMBERS + 1;
+		threads = (unsigned int)std::max(1ULL, std::min((llu)threads, chunks));
+		std::atomic<llu> nextChunk(0);
+		auto work = [&](unsigned int worker){
+			for(llu chunk; (chunk = nextChunk++) < chunks;){
+				llu from = lo + chunk * CHUNK_NUMBERS, to = std::min(hi, from + (CHUNK_NUMBERS - 1));
+				sieveRange(from, to, primes, [&](const unsigned char *bits, llu firstByte, size_t count){
+					visit(worker, bits, firstByte, count);
+				});
+			}
+		};
+		sharedPool().run(threads, work);
+	}
+
+	unsigned int defaultThreads(){
+		unsigned int threads = std::thread::hardware_concurrency();
+		return threads ? threads : 1;
+	}
+
+	// Call fn(p) for every prime p in [lo, hi].
+	// With one thread primes come in increasing order. With more, fn is called concurrently
+	// for disjoint chunks (increasing within a chunk), so it must be thread-safe.
+	template <typename Function> void forEachPrime(llu lo, llu hi, Function fn, unsigned int threads = 1){
+		if(lo > hi) return;
+		if(tableCovers(hi)){
+			for(const uint32_t *p = std::lower_bound(tableBegin(), tableEnd(), (uint32_t)lo); p != tableEnd() && *p <= hi; p++) fn(*p);
+			return;
+		}
+		const llu small[3] = {2, 3, 5};
+		for(llu p: small) if(lo <= p && p <= hi) fn(p);
+		parallelSieveRange(lo, hi, threads, [&fn](unsigned int, const unsigned char *bits, llu firstByte, size_t count){
+			for(size_t b=0; b<count; b++){
+				for(unsigned int byte = bits[b]; byte; byte &= byte - 1)
+					fn(30 * (firstByte + b) + wheel[__builtin_ctz(byte)]);
+			}
+		});
+	}
+
+	// Number of primes in [lo, hi]
+	llu countPrimes(llu lo, llu hi, unsigned int threads = defaultThreads()){
+		if(lo > hi) return 0;
+		if(tableCovers(hi)) return std::upper_bound(tableBegin(), tableEnd(), (uint32_t)hi)
+			- std::lower_bound(tableBegin(), tableEnd(), (uint32_t)lo);
+		llu result = 0;
+		const llu small[3] = {2, 3, 5};
+		for(llu p: small) if(lo <= p && p <= hi) result++;
+		threads = std::max(threads, 1u);
+		std::vector<llu> counts(threads, 0); // Per worker, summed after join
+		parallelSieveRange(lo, hi, threads, [&counts](unsigned int worker, const unsigned char *bits, llu, size_t count){
+			llu local = 0;
+			for(size_t b=0; b<count; b++) local += __builtin_popcount(bits[b]);
+			counts[worker] += local;
+		});
+		for(llu c: counts) result += c;
+		return result;
+	}
+}
 
 int main(void){
-	
+
 	// Get input
 	printf("Input upper bound to calculate all primes: ");
-	int n = 20000000; //scanf("%d", &n);
+	lld n = 20000000; //scanf("%lld", &n);
 	assert(2<=n);
-	
-	// Sieve of Eratosthenes
-	primes.clear();
-	isPrime = std::vector<bool>(n+1, true);
-	isPrime[0] = false; isPrime[1] = false;
-	for(int i=2; i<=n; i++){
-		if(isPrime[i]) primes.push_back(i);
-		for(int j=0; j<primes.size() && (lld)i*primes[j] <= (lld)n; j++){
-			isPrime[i*primes[j]] = false;
-			if(i % primes[j] == 0) break;
-		}
-	}
-	
+
+	// Table file if present, otherwise segmented sieve of Eratosthenes
+	if(WheelSieve::openTable("primes.bin")) printf("(using primes.bin) ");
+	llu total = WheelSieve::countPrimes(2, n);
+
 	// Show result
-	printf("Total %d primes under %d (showing only first 1000th): ", primes.size(), n); 
-	for(int i=0; i<1000 && i<primes.size(); i++) printf("%d ", primes[i]);
+	printf("Total %llu primes under %lld (showing only first 1000th): ", total, n);
+	int shown = 0;
+	WheelSieve::forEachPrime(2, std::min((llu)n, (llu)7919), [&shown](llu p){
+		if(shown++ < 1000) printf("%llu ", p);
+	});
 	printf("\n");
-	
+
+	// Multiplicative functions
+	MultiplicativeSieve<EulerPhi, Mobius, DivisorCount, DivisorSum> functions(20);
+	for(int i=1; i<=20; i++) printf("n = %d: phi = %d, mu = %d, d = %d, sigma = %lld\n", i,
+		functions.at<EulerPhi>(i), functions.at<Mobius>(i), functions.at<DivisorCount>(i), functions.at<DivisorSum>(i));
+
 	return 0;
 }
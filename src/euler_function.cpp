@@ -5,75 +5,246 @@
 
 #include <stdio.h>
 #include <vector>
+#include <algorithm>
+#include "prime_table_mmap.h"
 
 // Constants
 typedef long long int lld;
+typedef unsigned long long int llu;
 const int limit = 30000005;
+const char *PRIME_TABLE_PATH = "primes.bin"; // Written by prime_table_mmap.cpp
 
 // Attributes
-std::vector<bool> isPrime(limit, true);
+// Smallest prime factor of odd n < limit is stored at n/2, and 0 means n is prime.
+// Composite n has smallest factor <= sqrt(n) < 2^16, and even n is implied, so 2 bytes per 2 numbers is enough.
+// Points into the mapped table file if it covers limit, otherwise into sievedFactors.
+const unsigned short *smallestFactor;
+std::vector<unsigned short> sievedFactors;
+PrimeTable primeTable;
 std::vector<lld> primes;
 
-// euler(x) = count(for i in range(1, x+1) if coprime(i,x))
-lld euler(lld x){
-	
-	// Make copy
-	lld x_copy = x;
-	
-	// Calculate prime divisors
-	std::vector<lld> prime_divisors;
-	for(auto p: primes){
-		if(x <= 1) break;
-		else if(x < limit && isPrime[x]){ // isPrime -> prime
-			prime_divisors.push_back(x);
-			break;
-		}
-		else if(x >= limit && (lld)p*p > x){ // Cannot find divisors -> prime
-			prime_divisors.push_back(x);
-			break;
+// Map the prime table file, which costs one mmap instead of a sieve at every startup;
+// Without a usable file, linear sieve where every odd composite is written once, by its smallest prime factor.
+void sieve(){
+	if(primeTable.open(PRIME_TABLE_PATH) && primeTable.limit() >= (uint64_t)limit){
+		smallestFactor = primeTable.factorData();
+		for(size_t i=0; i<primeTable.primeCount() && primeTable.prime(i) < 100; i++) primes.push_back(primeTable.prime(i));
+		return;
+	}
+	primeTable.close();
+	sievedFactors.assign(limit/2 + 1, 0);
+	primes.push_back(2);
+	for(lld i=3; i<limit; i+=2){
+		lld f = sievedFactors[i/2];
+		if(f == 0) primes.push_back(i), f = i;
+		for(size_t j=1; j<primes.size() && primes[j] <= f && i*primes[j] < limit; j++)
+			sievedFactors[i*primes[j]/2] = (unsigned short)primes[j];
+	}
+	smallestFactor = sievedFactors.data();
+}
+
+// Smallest prime factor of 2 <= n < limit
+inline lld smallestPrimeFactor(lld n){
+	if(n % 2 == 0) return 2;
+	lld f = smallestFactor[n/2];
+	return f ? f : n;
+}
+
+// p^exponent
+struct PrimePower{
+	lld prime;
+	int exponent;
+};
+const int MAX_DISTINCT_PRIMES = 15; // 2*3*5*...*47 < 2^63 < 2*3*5*...*53
+
+// Montgomery multiplication modulo odd n; Values are kept as aR mod n with R = 2^64.
+struct Montgomery{
+	llu n, inv, r2; // n * inv = 1 mod 2^64, r2 = R^2 mod n
+	Montgomery(llu n): n(n), inv(n){
+		for(int i=0; i<5; i++) inv *= 2 - n * inv; // Each Newton step doubles correct low bits
+		r2 = (llu)(-(unsigned __int128)n % n);
+	}
+	// tR^(-1) mod n for t < nR; Low halves of t and m*n cancel, so only high halves are subtracted.
+	llu reduce(unsigned __int128 t) const{
+		llu m = (llu)t * inv, high = (llu)(t >> 64), mn = (llu)(((unsigned __int128)m * n) >> 64);
+		return high >= mn ? high - mn : high - mn + n;
+	}
+	llu multiply(llu a, llu b) const{return reduce((unsigned __int128)a * b);}
+	llu to(llu a) const{return multiply(a % n, r2);}
+	llu from(llu a) const{return reduce(a);}
+	llu power(llu a, llu x) const{
+		llu result = to(1);
+		for(; x; x >>= 1, a = multiply(a, a)) if(x&1) result = multiply(result, a);
+		return result;
+	}
+};
+
+llu gcd(llu a, llu b){
+	if(a == 0 || b == 0) return a | b;
+	int shift = __builtin_ctzll(a | b);
+	a >>= __builtin_ctzll(a);
+	while(b){
+		b >>= __builtin_ctzll(b);
+		if(a > b) std::swap(a, b);
+		b -= a;
+	}
+	return a << shift;
+}
+
+// Deterministic Miller-Rabin for 64 bits with the 7 Sinclair bases, same as miller_rabin_primality.cpp
+bool isPrime(llu n){
+	if(n < (llu)limit) return n >= 2 && (n == 2 || (n % 2 == 1 && smallestFactor[n/2] == 0));
+	const llu smallPrimes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+	for(llu p: smallPrimes) if(n % p == 0) return false;
+	const llu bases[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+	llu d = n - 1; int r = 0; // n = 2^r * d + 1
+	while(!(d&1)) r++, d >>= 1;
+	const Montgomery mont(n);
+	const llu one = mont.to(1), minusOne = mont.to(n-1);
+	for(llu a: bases){
+		if(a % n == 0) continue; // Base is a multiple of n; Tells nothing
+		llu x = mont.power(mont.to(a), d);
+		if(x == one || x == minusOne) continue;
+		int i = 1;
+		for(; i<r && x != minusOne; i++) x = mont.multiply(x, x);
+		if(x != minusOne) return false;
+	}
+	return true;
+}
+
+// Nontrivial factor of odd composite n by Pollard's rho with Brent's cycle detection.
+// Differences are multiplied together and gcd is taken once per batch.
+llu pollardRho(llu n){
+	const Montgomery mont(n);
+	const int BATCH = 128;
+	for(llu seed=1; ; seed++){
+		const llu c = mont.to(seed);
+		auto f = [&](llu v){llu w = mont.multiply(v, v) + c; return w >= n ? w - n : w;};
+		auto difference = [](llu a, llu b){return a > b ? a - b : b - a;};
+		llu x = 0, y = mont.to(2), saved = y, product = mont.to(1), g = 1;
+		for(llu length=1; g == 1; length <<= 1){
+			x = y;
+			for(llu i=0; i<length; i++) y = f(y);
+			for(llu done=0; done<length && g == 1; done += BATCH){
+				saved = y;
+				for(llu i=0; i<BATCH && done+i<length; i++) y = f(y), product = mont.multiply(product, difference(x, y));
+				g = gcd(product, n);
+			}
 		}
-		else if(x%p == 0){
-			prime_divisors.push_back(p);
-			while(x%p == 0) x /= p;
+		if(g == n){ // Batch overshot; Redo it one step at a time
+			do saved = f(saved), g = gcd(difference(x, saved), n); while(g == 1);
 		}
+		if(g != n) return g;
 	}
-	
-	// Calculate with bitwise
-	lld s = 0;
-	for(lld it=0; it<(1LL<<prime_divisors.size()); it++){
-		int included = 0;
-		lld mul = 1;
-		for(int digit=0; digit<prime_divisors.size(); digit++){
-			if(it&(1LL<<digit)){
-				included++;
-				mul *= prime_divisors[digit];
-			}
+}
+
+// Append prime factors of n with multiplicity to out
+void collectPrimes(llu n, llu *out, int &count){
+	if(n < (llu)limit){
+		for(; n > 1; n /= smallestPrimeFactor(n)) out[count++] = smallestPrimeFactor(n);
+		return;
+	}
+	if(isPrime(n)){out[count++] = n; return;}
+	llu d = pollardRho(n);
+	collectPrimes(d, out, count);
+	collectPrimes(n / d, out, count);
+}
+
+// Write prime factorization of x >= 1 into out in increasing order and return its length.
+// Below limit it costs one table lookup per prime factor; Above, small primes are divided out
+// and the rest is split by Pollard's rho until pieces are prime or fit in table.
+int factorize(lld x, PrimePower *out){
+	llu found[64]; int foundCount = 0;
+	llu rest = (llu)x;
+	for(size_t j=0; rest >= (llu)limit && j<primes.size() && primes[j] < 100; j++){
+		while(rest % primes[j] == 0) rest /= primes[j], found[foundCount++] = primes[j];
+	}
+	collectPrimes(rest, found, foundCount);
+	std::sort(found, found + foundCount);
+	int count = 0;
+	for(int i=0; i<foundCount; i++){
+		if(count > 0 && out[count-1].prime == (lld)found[i]) out[count-1].exponent++;
+		else out[count++] = {(lld)found[i], 1};
+	}
+	return count;
+}
+
+// euler(x) = count(for i in range(1, x+1) if coprime(i,x))
+lld euler(lld x){
+	PrimePower factors[MAX_DISTINCT_PRIMES];
+	int count = factorize(x, factors);
+	for(int i=0; i<count; i++) x = x / factors[i].prime * (factors[i].prime - 1);
+	return x;
+}
+
+// Number of positive divisors of x
+lld divisorCount(lld x){
+	PrimePower factors[MAX_DISTINCT_PRIMES];
+	int count = factorize(x, factors);
+	lld result = 1;
+	for(int i=0; i<count; i++) result *= factors[i].exponent + 1;
+	return result;
+}
+
+// Mobius function; 0 if x has square factor, otherwise (-1)^(number of prime factors)
+int mobius(lld x){
+	PrimePower factors[MAX_DISTINCT_PRIMES];
+	int count = factorize(x, factors);
+	for(int i=0; i<count; i++) if(factors[i].exponent > 1) return 0;
+	return count % 2 ? -1 : 1;
+}
+
+// All positive divisors of x in increasing order
+std::vector<lld> divisors(lld x){
+	PrimePower factors[MAX_DISTINCT_PRIMES];
+	int count = factorize(x, factors);
+	std::vector<lld> result(1, 1);
+	for(int i=0; i<count; i++){
+		size_t previous = result.size();
+		lld power = 1;
+		for(int e=1; e<=factors[i].exponent; e++){
+			power *= factors[i].prime;
+			for(size_t k=0; k<previous; k++) result.push_back(result[k] * power);
 		}
-		if(included%2 == 0) s += x_copy / mul;
-		else s -= x_copy / mul;
-	} return s;
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+// Factorize all values into one flat array;
+// Factors of values[i] are factors[offsets[i]], ..., factors[offsets[i+1]-1].
+void factorizeBatch(const std::vector<lld> &values, std::vector<PrimePower> &factors, std::vector<size_t> &offsets){
+	factors.clear();
+	offsets.assign(1, 0);
+	PrimePower buffer[MAX_DISTINCT_PRIMES];
+	for(lld x: values){
+		int count = factorize(x, buffer);
+		factors.insert(factors.end(), buffer, buffer + count);
+		offsets.push_back(factors.size());
+	}
 }
 
 int main(void){
 	
 	// Prime pre-calculation
 	printf("Please wait few seconds until prime pre-calculation is completed.\n");
-	isPrime[0] = false; isPrime[1] = false;
-	for(int i=2; i<limit; i++){
-		if(isPrime[i]){
-			primes.push_back(i);
-			for(int j=2*i; j<limit; j+=i) isPrime[j] = false;
-		}
-	}
+	sieve();
+	if(primeTable.isOpen()) printf("Loaded %s.\n", PRIME_TABLE_PATH);
 	
 	// Process queries
 	while(true){
 		printf("Input number to calculate euler function(0 to exit): ");
 		lld num; scanf("%lld", &num);
 		if(num==0) break;
-		else if(1 <= num && num <= (lld)(limit-1)*(limit-1)) printf("Euler(%lld) = %lld\n", num, euler(num));
 		else if(0 > num) printf("Negative number given, please try again.\n");
-		else printf("Given number is too large(bigger than %lld), please try again.\n", (lld)(limit-1)*(limit-1));
+		else{
+			printf("Euler(%lld) = %lld, divisors = %lld, mobius = %d\n", num, euler(num), divisorCount(num), mobius(num));
+			std::vector<lld> all = divisors(num);
+			if(all.size() <= 32){
+				for(lld d: all) printf("%lld ", d);
+				printf("\n");
+			}
+		}
 	}
 	
 	return 0;
@@ -87,27 +87,354 @@ namespace McDicCP{
         if(invert) for(int i=0; i<n; i++) poly[i] /= n;
     }
 
-    template <class t> std::vector<t> multiply(
+    // Returns smallest FFT length >= need among 2^k, 3*2^k and 5*2^k.
+    size_t fft_length(size_t need){
+        size_t best = 1;
+        while(best < need) best <<= 1;
+        for(size_t m: {3, 5}){
+            size_t len = m;
+            while(len < need) len <<= 1;
+            if(len < best) best = len;
+        }
+        return best;
+    }
+
+    // Mixed radix FFT for length m * 2^k where m is 1, 3 or 5.
+    // Splits into m interleaved radix-2 FFTs and merges them with O(n*m) twiddles.
+    void fft_mixed(std::vector<codo> &poly, bool invert){
+        const int n = (int)poly.size();
+        int m = n;
+        while(m % 2 == 0) m /= 2;
+        if(m == 1){fft(poly, invert); return;}
+        const int l = n / m;
+
+        // Sub-FFTs on poly[j*m + r]
+        std::vector<std::vector<codo>> sub(m, std::vector<codo>(l));
+        for(int j=0; j<l; j++) for(int r=0; r<m; r++) sub[r][j] = poly[j*m + r];
+        for(int r=0; r<m; r++) fft(sub[r], invert);
+
+        // Merge: X[q] = sum_r w^(rq) * sub[r][q mod l]; Roots are computed once per length
+        static std::map<int, std::vector<codo>> rootCache;
+        std::vector<codo> &roots = rootCache[n];
+        if(roots.empty()){
+            const double angle = 2 * (double)M_PI / n;
+            roots.resize(n);
+            for(int i=0; i<n; i++) roots[i] = codo(cos(angle * i), sin(angle * i));
+        }
+        for(int q=0; q<n; q++){
+            codo s = 0;
+            for(int r=0, e=0; r<m; r++, e = (e+q) % n) s += (invert ? std::conj(roots[e]) : roots[e]) * sub[r][q % l];
+            poly[q] = invert ? s / (double)m : s;
+        }
+    }
+
+    // Multiplication dispatch thresholds, measured by calibrate() below.
+    // Schoolbook is used while the shorter operand is at most SCHOOLBOOK_LIMIT,
+    // Karatsuba while it is at most KARATSUBA_LIMIT, and FFT otherwise.
+    // Only calibration builds may change them.
+#ifdef __McDic_calibrate__
+    size_t SCHOOLBOOK_LIMIT = 32;
+    size_t KARATSUBA_LIMIT = 6144;
+#else
+    const size_t SCHOOLBOOK_LIMIT = 32;
+    const size_t KARATSUBA_LIMIT = 6144;
+#endif
+
+    // result[0, n+m-1) += a[0, n) * b[0, m)
+    template <class t> void multiply_schoolbook(
+        const t *a, size_t n, const t *b, size_t m, t *result){
+        for(size_t i=0; i<n; i++){
+            if(a[i] == 0) continue;
+            for(size_t j=0; j<m; j++) result[i+j] += a[i] * b[j];
+        }
+    }
+
+    // result[0, 2n-1) += a[0, n) * b[0, n)
+    template <class t> void multiply_karatsuba(
+        const t *a, const t *b, size_t n, t *result){
+        if(n <= SCHOOLBOOK_LIMIT || n < 2){ // Splitting needs both halves nonempty
+            multiply_schoolbook(a, n, b, n, result);
+            return;
+        }
+
+        // (a1 x^h + a0)(b1 x^h + b0) = low + mid x^h + high x^2h
+        const size_t h = n/2, k = n-h;
+        std::vector<t> asum(a+h, a+n), bsum(b+h, b+n);
+        for(size_t i=0; i<h; i++) asum[i] += a[i], bsum[i] += b[i];
+        std::vector<t> low(2*h-1), high(2*k-1), mid(2*k-1);
+        multiply_karatsuba(a, b, h, low.data());
+        multiply_karatsuba(a+h, b+h, k, high.data());
+        multiply_karatsuba(asum.data(), bsum.data(), k, mid.data());
+        for(size_t i=0; i<low.size(); i++) mid[i] -= low[i], result[i] += low[i];
+        for(size_t i=0; i<high.size(); i++) mid[i] -= high[i], result[i+2*h] += high[i];
+        for(size_t i=0; i<mid.size(); i++) result[i+h] += mid[i];
+    }
+
+    template <class t> std::vector<t> multiply_fft(
         const std::vector<t> &a, const std::vector<t> &b){
 
         // Create temporary vector
+        const size_t need = a.size() + b.size() - 1, n = fft_length(need);
         std::vector<codo> poly1(a.begin(), a.end()),
                           poly2(b.begin(), b.end());
-        size_t n=1; 
-        while(n < a.size() + b.size()) n <<= 1;
         poly1.resize(n), poly2.resize(n);
 
         // FT -> Convolution -> IFT
-        fft(poly1, false); fft(poly2, false);
+        fft_mixed(poly1, false); fft_mixed(poly2, false);
         for(size_t i=0; i<n; i++) poly1[i] *= poly2[i];
-        fft(poly1, true);
+        fft_mixed(poly1, true);
 
         // Return
-        std::vector<t> result(n);
-        for(size_t i=0; i<n; i++) result[i] = round(poly1[i].real());
+        std::vector<t> result(need);
+        for(size_t i=0; i<need; i++) result[i] = round(poly1[i].real());
+        return result;
+    }
+
+    // Returns a * b with exactly a.size() + b.size() - 1 terms.
+    template <class t> std::vector<t> multiply(
+        const std::vector<t> &a, const std::vector<t> &b){
+        if(a.empty() || b.empty()) return std::vector<t>();
+        if(a.size() < b.size()) return multiply(b, a);
+        const size_t n = a.size(), m = b.size();
+        if(m > KARATSUBA_LIMIT) return multiply_fft(a, b);
+
+        std::vector<t> result(n+m-1);
+        if(m <= SCHOOLBOOK_LIMIT){
+            multiply_schoolbook(a.data(), n, b.data(), m, result.data());
+            return result;
+        }
+
+        // Unbalanced Karatsuba; Cut a into m-sized blocks
+        std::vector<t> block(m), partial(2*m-1);
+        for(size_t offset=0; offset<n; offset+=m){
+            size_t len = std::min(m, n-offset);
+            std::fill(block.begin(), block.end(), 0);
+            std::fill(partial.begin(), partial.end(), 0);
+            std::copy(a.begin()+offset, a.begin()+offset+len, block.begin());
+            multiply_karatsuba(block.data(), b.data(), m, partial.data());
+            for(size_t i=0; i<len+m-1; i++) result[offset+i] += partial[i];
+        }
         return result;
     }
 
+#ifdef __McDic_calibrate__
+    // Benchmarks each method on random balanced inputs and resets the thresholds
+    // to the observed crossover points. Run locally with -D__McDic_calibrate__.
+    void calibrate(){
+        auto measure = [](std::function<void()> f) -> double{
+            int repeat = 0;
+            auto start = std::chrono::steady_clock::now();
+            std::chrono::duration<double> elapsed;
+            do{
+                f(); repeat++;
+                elapsed = std::chrono::steady_clock::now() - start;
+            } while(elapsed.count() < 0.05);
+            return elapsed.count() / repeat;
+        };
+        const size_t oldSchoolbook = SCHOOLBOOK_LIMIT;
+        size_t newSchoolbook = 0, newKaratsuba = 0;
+        printf("%8s %14s %14s %14s %14s\n", "size", "schoolbook", "karatsuba1", "karatsuba", "fft");
+        for(size_t n=8; n<=(1<<16); n += (n < 64 ? 8 : n/4)){
+            std::vector<unsigned long long> a(n), b(n), result(2*n-1);
+            for(size_t i=0; i<n; i++) a[i] = mersenne_twister() % 1000, b[i] = mersenne_twister() % 1000;
+
+            // Karatsuba with exactly one level vs schoolbook decides SCHOOLBOOK_LIMIT,
+            // full Karatsuba vs FFT decides KARATSUBA_LIMIT.
+            double school = measure([&](){
+                multiply_schoolbook(a.data(), n, b.data(), n, result.data());});
+            SCHOOLBOOK_LIMIT = n-1;
+            double karaOne = measure([&](){
+                multiply_karatsuba(a.data(), b.data(), n, result.data());});
+            SCHOOLBOOK_LIMIT = oldSchoolbook;
+            double kara = measure([&](){
+                multiply_karatsuba(a.data(), b.data(), n, result.data());});
+            double fftTime = measure([&](){multiply_fft(a, b);});
+            printf("%8zu %14.3e %14.3e %14.3e %14.3e\n", n, school, karaOne, kara, fftTime);
+
+            if(newSchoolbook == 0 && karaOne < school) newSchoolbook = n;
+            if(newKaratsuba == 0 && fftTime < std::min(school, kara)) newKaratsuba = n;
+        }
+        if(newSchoolbook) SCHOOLBOOK_LIMIT = newSchoolbook;
+        if(newKaratsuba) KARATSUBA_LIMIT = newKaratsuba;
+        printf("SCHOOLBOOK_LIMIT = %zu, KARATSUBA_LIMIT = %zu\n",
+            SCHOOLBOOK_LIMIT, KARATSUBA_LIMIT);
+    }
+#endif
+
+    // Streaming linear convolution with a fixed kernel using overlap-save.
+    // Input arrives chunk by chunk and y[i] = sum_j kernel[j] * x[i-j] is emitted
+    // in blocks of (n - m + 1) samples, so memory stays O(n) regardless of stream length.
+    class StreamConvolver{
+    private:
+        size_t m, n, step; // Kernel length, FFT length, new samples per block
+        std::vector<codo> kernelFT, work;
+        std::vector<double> window; // Last m-1 samples followed by pending new samples
+        size_t filled; // Number of valid samples in window
+        bool started; // Any sample pushed since construction or last flush
+
+        // Convolve the current window and append its last `count` valid outputs
+        void process(size_t count, std::vector<double> &out){
+            std::fill(window.begin() + filled, window.end(), 0.0);
+            for(size_t i=0; i<n; i++) work[i] = window[i];
+            fft_mixed(work, false);
+            for(size_t i=0; i<n; i++) work[i] *= kernelFT[i];
+            fft_mixed(work, true);
+            for(size_t i=0; i<count; i++) out.push_back(work[m-1+i].real());
+
+            // Keep last m-1 samples as history
+            std::copy(window.begin() + step, window.begin() + step + (m-1), window.begin());
+            filled = m-1;
+        }
+
+    public:
+        // blockSize is FFT length; 0 means automatic choice of about 4m.
+        StreamConvolver(const std::vector<double> &kernel, size_t blockSize = 0){
+            if(kernel.empty()) throw "Empty kernel";
+            m = kernel.size();
+            n = fft_length(std::max(blockSize, std::max((size_t)64, 4*m)));
+            step = n - m + 1;
+            kernelFT = std::vector<codo>(kernel.begin(), kernel.end());
+            kernelFT.resize(n); fft_mixed(kernelFT, false);
+            work.resize(n);
+            window.assign(n, 0.0);
+            filled = m-1; // Zero history before the stream starts
+            started = false;
+        }
+
+        // Feed len samples; Every finished block is appended to out.
+        void push(const double *data, size_t len, std::vector<double> &out){
+            if(len > 0) started = true;
+            while(len > 0){
+                size_t take = std::min(len, n - filled);
+                std::copy(data, data + take, window.begin() + filled);
+                filled += take, data += take, len -= take;
+                if(filled == n) process(step, out);
+            }
+        }
+        void push(const std::vector<double> &chunk, std::vector<double> &out){
+            push(chunk.data(), chunk.size(), out);
+        }
+
+        // End of stream; Emit remaining outputs including the m-1 tail samples,
+        // then reset to the initial state so another stream can be fed.
+        // An empty stream has no output at all.
+        void flush(std::vector<double> &out){
+            size_t remain = started ? filled : 0; // Pending samples + (m-1) tail
+            while(remain > 0){
+                size_t count = std::min(remain, step);
+                process(count, out);
+                remain -= count;
+            }
+            std::fill(window.begin(), window.end(), 0.0);
+            filled = m-1, started = false;
+        }
+    };
+
+    // Many independent products of the same length sharing one plan.
+    // LANES transforms are stored interleaved ([index][lane]) so the butterfly's
+    // innermost loop runs over lanes with one shared twiddle and vectorizes.
+    // Two real inputs are packed into one complex transform (z = a + ib),
+    // so each product costs one forward and one inverse FFT.
+    // Each call transforms at the smallest power of 2 holding 2len-1 terms, reading
+    // the plan's twiddles with a stride, so short batches do not pay for maxlen.
+    class BatchFFT{
+    private:
+        static const size_t LANES = 4;
+        size_t maxlen, n; // Plan limit, and largest transform length
+        std::vector<double> cosTable, sinTable; // e^(2pi i k/n) for k < n/2
+        std::vector<size_t> rev; // Bit reversal for length size
+        size_t size; // Transform length of current batch
+        std::vector<double> re, im; // Workspace, n * LANES
+
+        // Prepare bit reversal for transform length size
+        void resize(size_t length){
+            if(length == size) return;
+            size = length;
+            rev.assign(size, 0);
+            for(size_t i=1; i<size; i++) rev[i] = (rev[i>>1]>>1) | ((i&1) ? size>>1 : 0);
+        }
+
+        void transform(bool invert){
+            for(size_t i=0; i<size; i++) if(i < rev[i]) for(size_t l=0; l<LANES; l++){
+                std::swap(re[i*LANES+l], re[rev[i]*LANES+l]);
+                std::swap(im[i*LANES+l], im[rev[i]*LANES+l]);
+            }
+            const double sign = invert ? -1.0 : 1.0;
+            for(size_t len=2; len<=size; len<<=1){
+                const size_t half = len/2, stride = n/len;
+                for(size_t offset=0; offset<size; offset+=len){
+                    for(size_t i=0; i<half; i++){
+                        const double wr = cosTable[i*stride], wi = sign * sinTable[i*stride];
+                        double *fr = &re[(offset+i)*LANES], *fi = &im[(offset+i)*LANES];
+                        double *br = &re[(offset+i+half)*LANES], *bi = &im[(offset+i+half)*LANES];
+                        for(size_t l=0; l<LANES; l++){
+                            const double xr = br[l]*wr - bi[l]*wi, xi = br[l]*wi + bi[l]*wr;
+                            br[l] = fr[l] - xr; bi[l] = fi[l] - xi;
+                            fr[l] += xr; fi[l] += xi;
+                        }
+                    }
+                }
+            }
+        }
+
+    public:
+        // Plan for products of polynomials with at most maxlen terms.
+        BatchFFT(size_t maxlen): maxlen(maxlen), size(0){
+            n = 1;
+            while(n < 2*maxlen) n <<= 1;
+            cosTable.resize(n/2), sinTable.resize(n/2);
+            for(size_t k=0; k<n/2; k++){
+                const double angle = 2 * (double)M_PI * k / n;
+                cosTable[k] = cos(angle), sinTable[k] = sin(angle);
+            }
+            re.resize(n * LANES), im.resize(n * LANES);
+        }
+
+        // out[c*(2len-1) + k] = (a_c * b_c)[k] where a_c = a[c*len, (c+1)*len) and
+        // likewise b_c, for c < count; len should be at most maxlen.
+        template <class t> void multiplyBatch(
+            const t *a, const t *b, size_t count, size_t len, t *out){
+            if(len == 0) return;
+            if(len > maxlen) throw "Batch length exceeds plan";
+            const size_t outlen = 2*len-1;
+            size_t length = 1;
+            while(length < outlen) length <<= 1;
+            resize(length);
+            for(size_t group=0; group<count; group+=LANES){
+                const size_t lanes = std::min(LANES, count-group);
+
+                // Pack a + ib
+                std::fill(re.begin(), re.begin() + size*LANES, 0.0);
+                std::fill(im.begin(), im.begin() + size*LANES, 0.0);
+                for(size_t l=0; l<lanes; l++){
+                    const t *pa = a + (group+l)*len, *pb = b + (group+l)*len;
+                    for(size_t i=0; i<len; i++) re[i*LANES+l] = pa[i], im[i*LANES+l] = pb[i];
+                }
+                transform(false);
+
+                // A[k]B[k] = (Z[k]^2 - conj(Z[-k])^2) / 4i
+                for(size_t k=0; k<=size/2; k++){
+                    const size_t j = (size-k) & (size-1);
+                    for(size_t l=0; l<LANES; l++){
+                        const double zr = re[k*LANES+l], zi = im[k*LANES+l],
+                                     yr = re[j*LANES+l], yi = im[j*LANES+l];
+                        // Z[k]^2 - conj(Z[j])^2 and Z[j]^2 - conj(Z[k])^2
+                        const double pkr = zr*zr - zi*zi - (yr*yr - yi*yi), pki = 2*zr*zi + 2*yr*yi;
+                        const double pjr = yr*yr - yi*yi - (zr*zr - zi*zi), pji = 2*yr*yi + 2*zr*zi;
+                        re[k*LANES+l] = pki / 4, im[k*LANES+l] = -pkr / 4;
+                        re[j*LANES+l] = pji / 4, im[j*LANES+l] = -pjr / 4;
+                    }
+                }
+                transform(true);
+
+                for(size_t l=0; l<lanes; l++){
+                    t *po = out + (group+l)*outlen;
+                    for(size_t i=0; i<outlen; i++) po[i] = round(re[i*LANES+l] / size);
+                }
+            }
+        }
+    };
+
     // Main solver function
     void solve(){
 
@@ -141,6 +468,11 @@ int main(int argc, char **argv){
     auto startedTime = std::chrono::steady_clock::now();
 #endif
 
+#ifdef __McDic_calibrate__ // Threshold calibration
+    McDicCP::calibrate();
+    return 0;
+#endif
+
     int testcases = 1; 
     //std::cin >> testcases;
     for(int t=1; t<=testcases; t++) McDicCP::solve();
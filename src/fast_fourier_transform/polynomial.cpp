@@ -0,0 +1,294 @@
+/*=============================================================================
+    McDic's Competitive Programming Template / Requires C++11 or later.
+    Last edited: 2020-08-18 15:10 UTC+9
+=============================================================================*/
+
+// Custom define
+#ifdef __McDic__ // Local testing
+#define debugprintf(f_, ...) fprintf(stderr, f_, ##__VA_ARGS__)
+#define debugflush() fflush(stdout),fflush(stderr)
+#else // Submission version
+#define debugprintf(f_, ...) NULL
+#define debugflush() NULL
+#endif
+//#define raise(f_, ...) {debugprintf(f_, ##__VA_ARGS__); exit(1000);}
+//#define raiseif(condition, f_, ...) if(condition) raise(f_, ##__VA_ARGS__)
+
+// Standard libraries
+#include <stdio.h>
+#include <iostream>
+#include <chrono> // For template clock
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <map>
+#include <set>
+#include <utility>
+
+// Random
+#include <random>
+std::mt19937_64 mersenne_twister(std::chrono::steady_clock::now().time_since_epoch().count());
+
+/*=============================================================================
+    Implement your own code below. 
+    To modify number of test cases, please look at Main function.
+=============================================================================*/
+
+namespace McDicCP{
+
+    typedef long long int lld;
+    typedef std::vector<lld> poly; // Coefficients, lower degree first
+    const lld MOD = 998244353, PRIMITIVE_ROOT = 3; // MOD = 119 * 2^23 + 1
+
+    lld power(lld a, lld x){ // a^x % MOD
+        lld result = 1; a %= MOD;
+        if(a < 0) a += MOD;
+        for(; x > 0; x >>= 1, a = a * a % MOD) if(x&1) result = result * a % MOD;
+        return result;
+    }
+    lld inverse(lld a){return power(a, MOD-2);}
+
+    // Number theoretic transform; poly.size() should be power of 2.
+    void ntt(poly &a, bool invert){
+        const int n = (int)a.size();
+        for(int i=1, j=0; i<n; i++){
+            int bit = n >> 1;
+            for(; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if(i < j) std::swap(a[i], a[j]);
+        }
+        for(int l=2; l<=n; l<<=1){
+            lld wl = power(PRIMITIVE_ROOT, (MOD-1) / l);
+            if(invert) wl = inverse(wl);
+            for(int offset=0; offset<n; offset+=l){
+                lld w = 1;
+                for(int i=0; i<l/2; i++){
+                    lld front = a[offset+i], back = a[offset+i+l/2] * w % MOD;
+                    a[offset+i]     = (front + back < MOD ? front + back : front + back - MOD);
+                    a[offset+i+l/2] = (front - back >= 0 ? front - back : front - back + MOD);
+                    w = w * wl % MOD;
+                }
+            }
+        }
+        if(invert){
+            lld ninv = inverse(n);
+            for(auto &x: a) x = x * ninv % MOD;
+        }
+    }
+
+    // Remove leading zero coefficients
+    void trim(poly &a){while(!a.empty() && a.back() == 0) a.pop_back();}
+
+    poly multiply(const poly &a, const poly &b){
+        if(a.empty() || b.empty()) return poly();
+        const size_t need = a.size() + b.size() - 1;
+        if(std::min(a.size(), b.size()) <= 32){ // Schoolbook is faster for short operand
+            poly result(need);
+            for(size_t i=0; i<a.size(); i++) for(size_t j=0; j<b.size(); j++)
+                result[i+j] = (result[i+j] + a[i] * b[j]) % MOD;
+            return result;
+        }
+        size_t n = 1;
+        while(n < need) n <<= 1;
+        poly fa(a), fb(b);
+        fa.resize(n), fb.resize(n);
+        ntt(fa, false); ntt(fb, false);
+        for(size_t i=0; i<n; i++) fa[i] = fa[i] * fb[i] % MOD;
+        ntt(fa, true);
+        fa.resize(need);
+        return fa;
+    }
+
+    poly add(const poly &a, const poly &b){
+        poly result(std::max(a.size(), b.size()));
+        for(size_t i=0; i<result.size(); i++){
+            if(i < a.size()) result[i] += a[i];
+            if(i < b.size()) result[i] += b[i];
+            if(result[i] >= MOD) result[i] -= MOD;
+        } return result;
+    }
+    poly subtract(const poly &a, const poly &b){
+        poly result(std::max(a.size(), b.size()));
+        for(size_t i=0; i<result.size(); i++){
+            if(i < a.size()) result[i] += a[i];
+            if(i < b.size()) result[i] -= b[i];
+            if(result[i] < 0) result[i] += MOD;
+        } return result;
+    }
+
+    poly derivative(const poly &a){
+        poly result(a.empty() ? 0 : a.size()-1);
+        for(size_t i=1; i<a.size(); i++) result[i-1] = a[i] * (lld)i % MOD;
+        return result;
+    }
+    poly integral(const poly &a){
+        poly result(a.size()+1);
+        std::vector<lld> inv(a.size()+1, 1); // inv[i] = 1/i
+        for(size_t i=2; i<=a.size(); i++) inv[i] = (MOD - (MOD/i) * inv[MOD%i] % MOD) % MOD;
+        for(size_t i=0; i<a.size(); i++) result[i+1] = a[i] * inv[i+1] % MOD;
+        return result;
+    }
+
+    // 1/a mod x^n by Newton iteration g <- g(2 - ag); Requires a[0] != 0.
+    poly inverse(const poly &a, size_t n){
+        if(a.empty() || a[0] == 0) throw "Series is not invertible";
+        poly g = {inverse(a[0])};
+        for(size_t len=1; len<n; len<<=1){
+            poly cut(a.begin(), a.begin() + std::min(a.size(), 2*len));
+            poly ag = multiply(cut, g); ag.resize(2*len);
+            for(auto &x: ag) x = (x == 0 ? 0 : MOD - x);
+            ag[0] = (ag[0] + 2) % MOD;
+            g = multiply(g, ag); g.resize(2*len);
+        }
+        g.resize(n);
+        return g;
+    }
+
+    // ln(a) mod x^n; Requires a[0] = 1.
+    poly log(const poly &a, size_t n){
+        if(a.empty() || a[0] != 1) throw "log requires constant term 1";
+        poly cut(a.begin(), a.begin() + std::min(a.size(), n));
+        poly result = multiply(derivative(cut), inverse(cut, n));
+        result.resize(n > 0 ? n-1 : 0);
+        result = integral(result);
+        result.resize(n);
+        return result;
+    }
+
+    // exp(a) mod x^n by Newton iteration g <- g(1 - ln g + a); Requires a[0] = 0.
+    poly exp(const poly &a, size_t n){
+        if(!a.empty() && a[0] != 0) throw "exp requires constant term 0";
+        poly g = {1};
+        for(size_t len=1; len<n; len<<=1){
+            poly cut(a.begin(), a.begin() + std::min(a.size(), 2*len));
+            poly factor = subtract(cut, log(g, 2*len));
+            factor[0] = (factor[0] + 1) % MOD;
+            g = multiply(g, factor); g.resize(2*len);
+        }
+        g.resize(n);
+        return g;
+    }
+
+    // Returns (quotient, remainder) of a / b in O(n log n); b should not be zero.
+    std::pair<poly, poly> divmod(poly a, poly b){
+        trim(a); trim(b);
+        if(b.empty()) throw "Division by zero polynomial";
+        if(a.size() < b.size()) return std::make_pair(poly(), a);
+        const size_t k = a.size() - b.size() + 1;
+        poly ra(a.rbegin(), a.rbegin() + k), rb(b.rbegin(), b.rend());
+        poly q = multiply(ra, inverse(rb, k));
+        q.resize(k); std::reverse(q.begin(), q.end());
+        poly r = subtract(a, multiply(b, q));
+        r.resize(b.size()-1); trim(r);
+        return std::make_pair(q, r);
+    }
+
+    // Subproduct tree over points; tree[node] = prod (x - xs[i]) for i in [l, r).
+    class SubproductTree{
+    private:
+        std::vector<lld> xs;
+        std::vector<poly> tree;
+        static const int DIRECT_LIMIT = 64; // Horner directly below this size
+
+        void build(int node, int l, int r){
+            if(r-l == 1){
+                tree[node] = {(MOD - xs[l]) % MOD, 1};
+                return;
+            }
+            int mid = (l+r) / 2;
+            build(2*node, l, mid); build(2*node+1, mid, r);
+            tree[node] = multiply(tree[2*node], tree[2*node+1]);
+        }
+        void evaluate(const poly &f, int node, int l, int r, std::vector<lld> &result) const{
+            if(r-l <= DIRECT_LIMIT){
+                for(int i=l; i<r; i++){
+                    lld value = 0;
+                    for(size_t j=f.size(); j-->0;) value = (value * xs[i] + f[j]) % MOD;
+                    result[i] = value;
+                } return;
+            }
+            int mid = (l+r) / 2;
+            evaluate(divmod(f, tree[2*node]).second, 2*node, l, mid, result);
+            evaluate(divmod(f, tree[2*node+1]).second, 2*node+1, mid, r, result);
+        }
+        poly combine(const std::vector<lld> &weights, int node, int l, int r) const{
+            if(r-l == 1) return poly(1, weights[l]);
+            int mid = (l+r) / 2;
+            return add(multiply(combine(weights, 2*node, l, mid), tree[2*node+1]),
+                       multiply(combine(weights, 2*node+1, mid, r), tree[2*node]));
+        }
+
+    public:
+        SubproductTree(const std::vector<lld> &points): xs(points){
+            for(auto &x: xs) x = (x % MOD + MOD) % MOD;
+            tree.resize(4 * std::max((size_t)1, xs.size()));
+            if(!xs.empty()) build(1, 0, (int)xs.size());
+        }
+
+        // f(xs[i]) for every i in O(n log^2 n)
+        std::vector<lld> evaluate(const poly &f) const{
+            std::vector<lld> result(xs.size());
+            if(!xs.empty()) evaluate(divmod(f, tree[1]).second, 1, 0, (int)xs.size(), result);
+            return result;
+        }
+
+        // Unique f with deg < n and f(xs[i]) = ys[i]; Points should be distinct.
+        poly interpolate(const std::vector<lld> &ys) const{
+            if(xs.empty()) return poly();
+            std::vector<lld> weights = evaluate(derivative(tree[1]));
+            for(size_t i=0; i<xs.size(); i++){
+                if(weights[i] == 0) throw "Duplicated interpolation points";
+                weights[i] = (ys[i] % MOD + MOD) % MOD * inverse(weights[i]) % MOD;
+            }
+            poly result = combine(weights, 1, 0, (int)xs.size());
+            trim(result);
+            return result;
+        }
+    };
+
+    // Main solver function
+    void solve(){
+
+        // Multipoint evaluation of a polynomial of n terms on m points
+        int n, m; scanf("%d %d", &n, &m);
+        poly f(n);
+        for(int i=0; i<n; i++) scanf("%lld", &f[i]);
+        std::vector<lld> xs(m);
+        for(int i=0; i<m; i++) scanf("%lld", &xs[i]);
+        std::vector<lld> values = SubproductTree(xs).evaluate(f);
+        for(int i=0; i<m; i++) printf("%lld ", values[i]);
+        printf("\n");
+    }
+
+}
+
+/*=============================================================================
+    int main();
+=============================================================================*/
+
+// Main
+int main(int argc, char **argv){
+#ifdef __McDic__ // Local testing
+    freopen("IO/input.txt", "r", stdin);
+    printf("================================================\n");
+    printf(" McDic's C++17 file execution for CP\n");
+    printf("================================================\n");
+    freopen("IO/output.txt", "w", stdout);
+    freopen("IO/debug.txt", "w", stderr);
+    auto startedTime = std::chrono::steady_clock::now();
+#endif
+
+    int testcases = 1; 
+    //std::cin >> testcases;
+    for(int t=1; t<=testcases; t++) McDicCP::solve();
+
+#ifdef __McDic__ // Local testing
+    auto endTime = std::chrono::steady_clock::now();
+    std::chrono::duration<double> duration = endTime - startedTime;
+    debugprintf("\n"); for(int i=0; i<80; i++) debugprintf("="); debugprintf("\n");
+    debugprintf("Total %.8lf ms used.\n", duration.count());
+#endif
+    return 0;
+}
\ No newline at end of file
@@ -1,20 +1,199 @@
 /*
 	Author: McDic
 	Description: Calculation of power operation with divide and conquer.
+	Requires C++14, since power and ModInt are evaluated at compile time through constexpr loops.
 */
 
 #include <stdio.h>
+#include <stddef.h>
+#include <array>
 
 // Shorter name
 typedef long long int lld;
+typedef unsigned long long int llu;
+typedef unsigned __int128 lllu;
 
-// Power calculation with divide and conquer
-lld power(lld a, lld n, lld r){ // a^n % r
-	if(n==0) return 1LL;
-	lld half = power(a, n>>1, r); // a^(n/2) % r
-	if(n%2==0) return half*half%r;
-	else return half*half%r*a%r;
+// Barrett reduction for r < 2^32; Products of reduced values fit in 64 bits,
+// and q = x * floor((2^64-1) / r) / 2^64 is below x / r by less than 2.
+struct Barrett{
+	llu r, m, unit;
+	constexpr Barrett(llu r): r(r), m(~0ULL / r), unit(1 % r){}
+	constexpr llu reduce(llu x) const{
+		llu rest = x - (llu)(((lllu)x * m) >> 64) * r;
+		return rest >= r ? rest - r : rest;
+	}
+	constexpr llu to(llu a) const{return a % r;}
+	constexpr llu from(llu a) const{return a;}
+	constexpr llu one() const{return unit;}
+	constexpr llu multiply(llu a, llu b) const{return reduce(a * b);}
+};
+
+// Montgomery reduction for odd r < 2^63; Values are kept as aR mod r with R = 2^64.
+struct Montgomery{
+	llu r, inv, r2, unit; // r * inv = 1 mod 2^64, r2 = R^2 mod r, unit = R mod r
+	constexpr Montgomery(llu r): r(r), inv(inverse(r)), r2((llu)(-(lllu)r % r)), unit((0 - r) % r){}
+	static constexpr llu inverse(llu r){
+		llu x = r;
+		for(int i=0; i<5; i++) x *= 2 - r * x; // Each Newton step doubles correct low bits
+		return x;
+	}
+	// tR^(-1) mod r for t < rR; Low halves of t and m*r cancel, so only high halves are subtracted.
+	constexpr llu reduce(lllu t) const{
+		llu m = (llu)t * inv, high = (llu)(t >> 64), mr = (llu)(((lllu)m * r) >> 64);
+		return high >= mr ? high - mr : high - mr + r;
+	}
+	constexpr llu to(llu a) const{return reduce((lllu)(a % r) * r2);}
+	constexpr llu from(llu a) const{return reduce(a);}
+	constexpr llu one() const{return unit;}
+	constexpr llu multiply(llu a, llu b) const{return reduce((lllu)a * b);}
+};
+
+// a^n with given reduction context, binary exponentiation from lowest bit
+template <typename Reducer> constexpr llu powerWith(const Reducer &reducer, llu a, llu n){
+	llu result = reducer.one(), x = reducer.to(a);
+	for(; n; n >>= 1, x = reducer.multiply(x, x)) if(n&1) result = reducer.multiply(result, x);
+	return reducer.from(result);
+}
+
+// Power calculation; a^n % r for r >= 1, iterative and without division inside the loop
+// unless r is even and at least 2^32.
+constexpr lld power(lld a, lld n, lld r){
+	a %= r;
+	if(a < 0) a += r;
+	if(r & 1) return (lld)powerWith(Montgomery(r), a, n);
+	if(r < (1LL << 32)) return (lld)powerWith(Barrett(r), a, n);
+	llu result = 1 % r, x = a;
+	for(llu e = n; e; e >>= 1, x = (lllu)x * x % r) if(e&1) result = (lllu)result * x % r;
+	return (lld)result;
+}
+static_assert(power(3, 200, 1000000007) == 136318165, "power should be usable in constant expressions");
+
+// Modular integer with compile-time modulus M <= 2^31; Every % has a constant divisor,
+// so the compiler turns it into multiplications.
+template <unsigned int M> class ModInt{
+	static_assert(1 <= M && M <= (1U << 31), "Sum of two residues should fit in 32 bits");
+public:
+	unsigned int value;
+	constexpr ModInt(): value(0){}
+	constexpr ModInt(lld x): value((unsigned int)(x % (lld)M < 0 ? x % (lld)M + M : x % (lld)M)){}
+	static constexpr unsigned int modulus(){return M;}
+	constexpr explicit operator lld() const{return value;}
+
+	constexpr ModInt &operator +=(const ModInt &another){value += another.value; if(value >= M) value -= M; return *this;}
+	constexpr ModInt &operator -=(const ModInt &another){value += M - another.value; if(value >= M) value -= M; return *this;}
+	constexpr ModInt &operator *=(const ModInt &another){value = (unsigned int)((unsigned long long)value * another.value % M); return *this;}
+	constexpr ModInt &operator /=(const ModInt &another){return *this *= another.inverse();}
+	constexpr ModInt operator -() const{return ModInt() -= *this;}
+	friend constexpr ModInt operator +(ModInt a, const ModInt &b){return a += b;}
+	friend constexpr ModInt operator -(ModInt a, const ModInt &b){return a -= b;}
+	friend constexpr ModInt operator *(ModInt a, const ModInt &b){return a *= b;}
+	friend constexpr ModInt operator /(ModInt a, const ModInt &b){return a /= b;}
+	friend constexpr bool operator ==(const ModInt &a, const ModInt &b){return a.value == b.value;}
+	friend constexpr bool operator !=(const ModInt &a, const ModInt &b){return a.value != b.value;}
+
+	constexpr ModInt pow(unsigned long long n) const{
+		ModInt result(1), x = *this;
+		for(; n; n >>= 1, x *= x) if(n&1) result *= x;
+		return result;
+	}
+	// Extended Euclid; value should be coprime to M
+	constexpr ModInt inverse() const{
+		lld a = value, b = M, x = 1, y = 0;
+		while(b){
+			lld q = a / b, t = a - q * b; a = b, b = t;
+			t = x - q * y; x = y, y = t;
+		}
+		return ModInt(x);
+	}
+};
+
+// Modular integer with modulus m <= 2^31 set at runtime, shared by every DynamicModInt<id> of the same id;
+// Products go through Barrett, so there is no hardware division either.
+template <int id> class DynamicModInt{
+	static Barrett &context(){static Barrett barrett(1); return barrett;}
+public:
+	unsigned int value;
+	static void setModulus(unsigned int m){context() = Barrett(m);}
+	static unsigned int modulus(){return (unsigned int)context().r;}
+	DynamicModInt(): value(0){}
+	DynamicModInt(lld x){
+		const lld m = modulus();
+		x %= m;
+		value = (unsigned int)(x < 0 ? x + m : x);
+	}
+	explicit operator lld() const{return value;}
+
+	DynamicModInt &operator +=(const DynamicModInt &another){value += another.value; if(value >= modulus()) value -= modulus(); return *this;}
+	DynamicModInt &operator -=(const DynamicModInt &another){value += modulus() - another.value; if(value >= modulus()) value -= modulus(); return *this;}
+	DynamicModInt &operator *=(const DynamicModInt &another){value = (unsigned int)context().multiply(value, another.value); return *this;}
+	DynamicModInt &operator /=(const DynamicModInt &another){return *this *= another.inverse();}
+	DynamicModInt operator -() const{return DynamicModInt() -= *this;}
+	friend DynamicModInt operator +(DynamicModInt a, const DynamicModInt &b){return a += b;}
+	friend DynamicModInt operator -(DynamicModInt a, const DynamicModInt &b){return a -= b;}
+	friend DynamicModInt operator *(DynamicModInt a, const DynamicModInt &b){return a *= b;}
+	friend DynamicModInt operator /(DynamicModInt a, const DynamicModInt &b){return a /= b;}
+	friend bool operator ==(const DynamicModInt &a, const DynamicModInt &b){return a.value == b.value;}
+	friend bool operator !=(const DynamicModInt &a, const DynamicModInt &b){return a.value != b.value;}
+
+	DynamicModInt pow(unsigned long long n) const{
+		DynamicModInt result(1), x = *this;
+		for(; n; n >>= 1, x *= x) if(n&1) result *= x;
+		return result;
+	}
+	// Extended Euclid; value should be coprime to modulus
+	DynamicModInt inverse() const{
+		lld a = value, b = modulus(), x = 1, y = 0;
+		while(b){
+			lld q = a / b, t = a - q * b; a = b, b = t;
+			t = x - q * y; x = y, y = t;
+		}
+		return DynamicModInt(x);
+	}
+};
+
+// a^n for any type with *= and construction from 1, such as ModInt<M> or DynamicModInt<id>
+template <typename T> constexpr T power(T a, llu n){
+	T result(1);
+	for(; n; n >>= 1, a *= a) if(n&1) result *= a;
+	return result;
 }
+static_assert(power(ModInt<1000000007>(3), 200).value == 136318165, "ModInt power should be usable in constant expressions");
+
+// Fixed base and modulus; table[k * DIGITS + d] = base^(d * 2^(WINDOW * k)) in reducer form,
+// so any 64-bit exponent costs one product per nonzero window and no squaring.
+template <typename Reducer, int WINDOW = 8> class ModPow{
+public:
+	static constexpr int WINDOWS = (64 + WINDOW - 1) / WINDOW, DIGITS = 1 << WINDOW;
+
+private:
+	Reducer reducer;
+	std::array<llu, WINDOWS * DIGITS> table;
+
+public:
+	constexpr ModPow(llu base, llu r): reducer(r), table(){
+		llu step = reducer.to(base); // base^(2^(WINDOW * k))
+		for(int k=0; k<WINDOWS; k++){
+			table[k * DIGITS] = reducer.one();
+			for(int d=1; d<DIGITS; d++) table[k * DIGITS + d] = reducer.multiply(table[k * DIGITS + d - 1], step);
+			step = reducer.multiply(table[k * DIGITS + DIGITS - 1], step);
+		}
+	}
+
+	// base^n % r
+	constexpr llu operator()(llu n) const{
+		llu result = reducer.one();
+		for(int k=0; n; k++, n >>= WINDOW){
+			if(n & (DIGITS - 1)) result = reducer.multiply(result, table[k * DIGITS + (n & (DIGITS - 1))]);
+		}
+		return reducer.from(result);
+	}
+
+	// out[i] = base^exponents[i] % r; Product chains of different exponents are independent,
+	// so out-of-order execution overlaps them without explicit interleaving.
+	void operator()(const llu *exponents, size_t count, llu *out) const{
+		for(size_t i=0; i<count; i++) out[i] = (*this)(exponents[i]);
+	}
+};
 
 int main(void){
 	
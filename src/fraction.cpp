@@ -1,111 +1,375 @@
 #include <stdio.h>
 #include <string>
 #include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <limits.h>
+
+// Number type helpers for Fraction. numtype can be built-in integer or
+// arbitrary precision integer like BigInt in big_integer.cpp (paste it above).
+namespace FractionTraits{
+
+	// Stein's binary GCD for non-negative built-in integers up to 64 bits
+	template <typename numtype> numtype binaryGcd(numtype a, numtype b){
+		unsigned long long x = a, y = b;
+		if(x == 0) return b;
+		if(y == 0) return a;
+		const int shift = __builtin_ctzll(x | y);
+		x >>= __builtin_ctzll(x);
+		do{
+			y >>= __builtin_ctzll(y);
+			if(x > y) std::swap(x, y);
+			y -= x;
+		} while(y != 0);
+		return (numtype)(x << shift);
+	}
+
+	// Built-in integers that fit in unsigned long long; Wider ones such as __int128,
+	// which is integral under gnu++, would lose their upper bits in binaryGcd.
+	template <typename numtype> struct IsWord{
+		static const bool value = std::is_integral<numtype>::value && sizeof(numtype) <= sizeof(unsigned long long);
+	};
+
+	// GCD of non-negative numbers; Prefers numtype::gcd (Lehmer's for BigInt),
+	// then binary GCD for built-in integers up to 64 bits, then Euclid on numtype's own %.
+	template <typename numtype> auto gcd(const numtype &a, const numtype &b, int)
+		-> decltype(numtype::gcd(a, b)){return numtype::gcd(a, b);}
+	template <typename numtype> typename std::enable_if<IsWord<numtype>::value, numtype>::type
+		gcd(const numtype &a, const numtype &b, long){return binaryGcd(a, b);}
+	template <typename numtype> typename std::enable_if<!IsWord<numtype>::value, numtype>::type
+		gcd(numtype a, numtype b, long){
+		while(b != numtype(0)){a %= b; std::swap(a, b);}
+		return a;
+	}
+	template <typename numtype> numtype gcd(const numtype &a, const numtype &b){return gcd(a, b, 0);}
+
+	// Size in bits for numbers with bitLength(); Built-in integers report 0,
+	// which makes Fraction reduce eagerly since they overflow otherwise.
+	template <typename numtype> auto bits(const numtype &x, int) -> decltype((size_t)x.bitLength()){
+		return x.bitLength();}
+	template <typename numtype> size_t bits(const numtype &, long){return 0;}
+	template <typename numtype> size_t bits(const numtype &x){return bits(x, 0);}
+
+	// Conversion to long double, through decimal string if there is no direct cast
+	template <typename numtype> auto toLongDouble(const numtype &x, int) -> decltype((long double)x){
+		return (long double)x;}
+	template <typename numtype> long double toLongDouble(const numtype &x, long){
+		return std::stold(x.str());}
+	template <typename numtype> long double toLongDouble(const numtype &x){return toLongDouble(x, 0);}
+}
 
 // Fraction class
 template <typename numtype> class Fraction{
 private:
-	
+
 	// Numbers
 	bool isPositive;
-	numtype upnumber, downnumber;
+	numtype upnumber, downnumber; // Both non-negative
+	bool isReduced; // gcd(upnumber, downnumber) == 1 is known
+	size_t reducedBits; // Size right after last reduction
+
+	// Reduction is deferred until size reaches 2 * reducedBits + LAZY_SLACK_BITS.
+	static const size_t LAZY_SLACK_BITS = 256;
 
 protected:
-	
-	// GCD for positive numbers
-	static numtype gcd(numtype a, numtype b){
-		if(a<0) a = -a;
-		if(b<0) b = -b;
-		if(a==0) return b;
-		else if(b==0) return a;
-		else return gcd(b, a%b);
-	}
-	
-	// Clean upnumber and downnumber
-	void clean(){
-		
-		// Sign handling
-		if(downnumber < 0){
+
+	// Sign handling; Makes both numbers non-negative.
+	void cleanSign(){
+		if(downnumber < numtype(0)){
 			isPositive = !isPositive;
 			downnumber = -downnumber;
 		}
-		else if(downnumber == 0){
+		else if(downnumber == numtype(0)){
 			printf("[Fatal Error] Down is zero\n");
 			throw "Down is zero";
 		}
-		if(upnumber < 0){
+		if(upnumber < numtype(0)){
 			isPositive = !isPositive;
 			upnumber = -upnumber;
 		}
-		else if(upnumber == 0){ // Special case
+		else if(upnumber == numtype(0)){ // Special case
 			isPositive = true;
-			upnumber = 0;
-			downnumber = 1;
-			return;
+			downnumber = numtype(1);
+			isReduced = true;
+		}
+	}
+
+	// Divide by gcd
+	void reduce(){
+		if(isReduced) return;
+		numtype thisgcd = FractionTraits::gcd(upnumber, downnumber);
+		if(thisgcd != numtype(1)){
+			upnumber /= thisgcd;
+			downnumber /= thisgcd;
 		}
-		
-		// Divide by gcd
-		numtype thisgcd = gcd(upnumber, downnumber);
-		upnumber /= thisgcd;
-		downnumber /= thisgcd;
+		isReduced = true;
+		reducedBits = FractionTraits::bits(upnumber) + FractionTraits::bits(downnumber);
+	}
+
+	// Reduce if eager (built-in integers) or grown past lazy threshold
+	void maybeReduce(){
+		if(isReduced) return;
+		size_t size = FractionTraits::bits(upnumber) + FractionTraits::bits(downnumber);
+		if(size == 0 || size >= 2 * reducedBits + LAZY_SLACK_BITS) reduce();
+	}
+
+	// Clean upnumber and downnumber
+	void clean(){
+		cleanSign();
+		maybeReduce();
 	}
-	
+
+	// Build from non-negative numbers without any cleaning; Unreduced results
+	// inherit the larger operand threshold so lazy reduction carries through chains.
+	static Fraction raw(bool isPositive, const numtype &up, const numtype &down, bool isReduced, size_t inheritedBits){
+		Fraction result;
+		result.isPositive = isPositive || up == numtype(0);
+		result.upnumber = up, result.downnumber = down;
+		result.isReduced = isReduced;
+		result.reducedBits = isReduced ? FractionTraits::bits(up) + FractionTraits::bits(down) : inheritedBits;
+		result.maybeReduce();
+		return result;
+	}
+
+	// Signed numerator
+	numtype signedUp() const{return isPositive ? upnumber : -upnumber;}
+
+	// Compare this and another by cross multiplication; No reduction needed.
+	int compare(const Fraction &another) const{
+		if(isPositive != another.isPositive) return isPositive ? 1 : -1;
+		numtype left = upnumber * another.downnumber, right = another.upnumber * downnumber;
+		int result = (left < right ? -1 : (right < left ? 1 : 0));
+		return isPositive ? result : -result;
+	}
+
 public:
-	
+
 	// Constructor
-	Fraction(numtype up, numtype down){
+	Fraction(numtype up = numtype(0), numtype down = numtype(1)){
 		upnumber = up, downnumber = down;
 		isPositive = true;
+		isReduced = false, reducedBits = 0;
 		clean();
 	}
-	
-	// Type casting
+
+	// Whether gcd(upnumber, downnumber) == 1 is currently known
+	bool reduced() const{return isReduced;}
+
+	// Type casting; Output is always reduced.
 	std::pair<numtype, numtype> make_pair(){
-		return std::make_pair(upnumber * (isPositive ? 1:-1), downnumber);}
+		reduce();
+		return std::make_pair(signedUp(), downnumber);}
 	operator double() const{
-		return (isPositive ? 1:-1) * (double)upnumber / (double)downnumber;}
+		return (double)this->operator long double();}
 	operator long double() const{
-		return (isPositive ? 1:-1) * (long double)upnumber / (long double)downnumber;}
-	
+		return (isPositive ? 1:-1) * FractionTraits::toLongDouble(upnumber) / FractionTraits::toLongDouble(downnumber);}
+
 	// Arithmetic unary operators
-	Fraction operator -(){ // - this
+	Fraction operator -() const{ // - this
 		Fraction newfraction = *this;
-		newfraction.isPositive = !newfraction.isPositive;
+		if(newfraction.upnumber != numtype(0)) newfraction.isPositive = !newfraction.isPositive;
 		return newfraction;
 	}
-	Fraction operator +(){ // + this
+	Fraction operator +() const{ // + this
 		return *this;
 	}
-	
+
 	// Arithmetic comparisons for long long int
-	bool operator == (long long int num){
-		return upnumber * (isPositive ? 1LL : -1LL) == downnumber * num; }
-	bool operator < (long long int num){
-		return upnumber * (isPositive ? 1LL : -1LL) < downnumber * num; }
-	bool operator > (long long int num){
-		return upnumber * (isPositive ? 1LL : -1LL) > downnumber * num; }
-	bool operator != (long long int num){ return !(this->operator == (num));}
-	bool operator <= (long long int num){ return !(this->operator > (num));}
-	bool operator >= (long long int num){ return !(this->operator < (num));}
-	
+	bool operator == (long long int num) const{
+		return signedUp() == downnumber * numtype(num); }
+	bool operator < (long long int num) const{
+		return signedUp() < downnumber * numtype(num); }
+	bool operator > (long long int num) const{
+		return signedUp() > downnumber * numtype(num); }
+	bool operator != (long long int num) const{ return !(this->operator == (num));}
+	bool operator <= (long long int num) const{ return !(this->operator > (num));}
+	bool operator >= (long long int num) const{ return !(this->operator < (num));}
+
 	// Arithmetic comparisons between fractions
-	bool operator == (const Fraction &num){
-		
+	bool operator == (const Fraction &num) const{ return compare(num) == 0;}
+	bool operator != (const Fraction &num) const{ return compare(num) != 0;}
+	bool operator < (const Fraction &num) const{ return compare(num) < 0;}
+	bool operator > (const Fraction &num) const{ return compare(num) > 0;}
+	bool operator <= (const Fraction &num) const{ return compare(num) <= 0;}
+	bool operator >= (const Fraction &num) const{ return compare(num) >= 0;}
+
+	// Arithmetic base binary operators
+	Fraction operator +(const Fraction &another) const{ // this + another
+		numtype up = signedUp() * another.downnumber + another.signedUp() * downnumber;
+		bool positive = !(up < numtype(0));
+		return raw(positive, positive ? up : -up, downnumber * another.downnumber, false,
+			std::max(reducedBits, another.reducedBits));
+	}
+	Fraction operator -(const Fraction &another) const{ // this - another
+		return this->operator +(-another);
+	}
+	Fraction operator *(const Fraction &another) const{ // this * another
+
+		// Cross reduction keeps products small; Result is reduced if both operands are.
+		numtype g1 = FractionTraits::gcd(upnumber, another.downnumber),
+		        g2 = FractionTraits::gcd(another.upnumber, downnumber);
+		return raw(isPositive == another.isPositive,
+			(upnumber / g1) * (another.upnumber / g2),
+			(downnumber / g2) * (another.downnumber / g1),
+			isReduced && another.isReduced, std::max(reducedBits, another.reducedBits));
 	}
-	
+	Fraction operator /(const Fraction &another) const{ // this / another
+		if(another.upnumber == numtype(0)){
+			printf("[Fatal Error] Division by zero\n");
+			throw "Division by zero";
+		}
+		Fraction inverted = raw(another.isPositive, another.downnumber, another.upnumber, another.isReduced, another.reducedBits);
+		return this->operator *(inverted);
+	}
+	Fraction& operator +=(const Fraction &another){return *this = *this + another;}
+	Fraction& operator -=(const Fraction &another){return *this = *this - another;}
+	Fraction& operator *=(const Fraction &another){return *this = *this * another;}
+	Fraction& operator /=(const Fraction &another){return *this = *this / another;}
+
+};
+
+// Specialization for long long int; Always reduced, and every intermediate
+// product is done in __int128 so nothing overflows before reduction.
+template <> class Fraction<long long int>{
+private:
+
+	typedef long long int lld;
+	typedef __int128 llld;
+
+	// Numbers; Sign is kept in upnumber, downnumber > 0 and gcd(|upnumber|, downnumber) = 1.
+	// Both stay within [-LLONG_MAX, LLONG_MAX] so negation never overflows; A reduced value
+	// needing LLONG_MIN, such as Fraction(LLONG_MIN, 1), throws "Fraction overflow".
+	lld upnumber, downnumber;
+
+	// Construct from already reduced numbers
+	struct Reduced{};
+	Fraction(lld up, lld down, Reduced): upnumber(up), downnumber(down){}
+
+	// Binary GCD with count trailing zeros, written as single returns so it stays constexpr in C++11;
+	// The tail calls compile into the same loop as the iterative version.
+	static constexpr unsigned long long oddPart(unsigned long long x){return x >> __builtin_ctzll(x);}
+	static constexpr unsigned long long gcdOdd(unsigned long long a, unsigned long long b){ // Both odd
+		return a == b ? a : a < b ? gcdStep(a, b - a) : gcdStep(b, a - b);
+	}
+	static constexpr unsigned long long gcdStep(unsigned long long a, unsigned long long b){ // a odd
+		return b == 0 ? a : gcdOdd(a, oddPart(b));
+	}
+	static constexpr unsigned long long gcd(unsigned long long a, unsigned long long b){
+		return a == 0 ? b : b == 0 ? a : gcdStep(oddPart(a), b) << __builtin_ctzll(a | b);
+	}
+	static constexpr unsigned long long absolute(llld x){return (unsigned long long)(x < 0 ? -x : x);}
+
+	// Narrow reduced 128-bit result back, failing loudly instead of wrapping
+	static Fraction narrow(llld up, llld down){
+		if(up > LLONG_MAX || up < -LLONG_MAX || down > LLONG_MAX){
+			printf("[Fatal Error] Fraction overflow\n");
+			throw "Fraction overflow";
+		}
+		return Fraction((lld)up, (lld)down, Reduced());
+	}
+
+	// Compare this and another without division; Returns -1, 0 or 1.
+	int compare(const Fraction &another) const{
+		llld left = (llld)upnumber * another.downnumber, right = (llld)another.upnumber * downnumber;
+		return (left > right) - (left < right);
+	}
+
+public:
+
+	// Constructor
+	Fraction(lld up = 0, lld down = 1){
+		if(down == 0){
+			printf("[Fatal Error] Down is zero\n");
+			throw "Down is zero";
+		}
+		llld u = up, d = down;
+		if(d < 0) u = -u, d = -d;
+		unsigned long long g = gcd(absolute(u), (unsigned long long)d);
+		*this = narrow(u / g, d / g);
+	}
+
+	// Type casting
+	std::pair<lld, lld> make_pair() const{
+		return std::make_pair(upnumber, downnumber);}
+	operator double() const{
+		return (double)upnumber / (double)downnumber;}
+	operator long double() const{
+		return (long double)upnumber / (long double)downnumber;}
+
+	// Arithmetic unary operators
+	Fraction operator -() const{ // - this
+		Fraction newfraction = *this;
+		newfraction.upnumber = -newfraction.upnumber;
+		return newfraction;
+	}
+	Fraction operator +() const{ // + this
+		return *this;
+	}
+
+	// Arithmetic comparisons for long long int
+	bool operator == (lld num) const{ return downnumber == 1 && upnumber == num;}
+	bool operator < (lld num) const{ return upnumber < (llld)downnumber * num;}
+	bool operator > (lld num) const{ return upnumber > (llld)downnumber * num;}
+	bool operator != (lld num) const{ return !(this->operator == (num));}
+	bool operator <= (lld num) const{ return !(this->operator > (num));}
+	bool operator >= (lld num) const{ return !(this->operator < (num));}
+
+	// Arithmetic comparisons between fractions; Reduced form makes equality exact.
+	bool operator == (const Fraction &num) const{ return upnumber == num.upnumber && downnumber == num.downnumber;}
+	bool operator != (const Fraction &num) const{ return !(this->operator == (num));}
+	bool operator < (const Fraction &num) const{ return compare(num) < 0;}
+	bool operator > (const Fraction &num) const{ return compare(num) > 0;}
+	bool operator <= (const Fraction &num) const{ return compare(num) <= 0;}
+	bool operator >= (const Fraction &num) const{ return compare(num) >= 0;}
+
 	// Arithmetic base binary operators
-	Fraction operator +(const Fraction &another){ // this + another
-		
+	Fraction operator +(const Fraction &another) const{ // this + another
+
+		// With g = gcd(b, d): a/b + c/d = (a(d/g) + c(b/g)) / (b/g * d),
+		// and only gcd(numerator, g) can remain.
+		unsigned long long g = gcd(downnumber, another.downnumber);
+		llld up = (llld)upnumber * (another.downnumber / (lld)g) + (llld)another.upnumber * (downnumber / (lld)g);
+		llld down = (llld)(downnumber / (lld)g) * another.downnumber;
+		unsigned long long g2 = gcd((unsigned long long)((up < 0 ? -up : up) % g), g);
+		return narrow(up / g2, down / g2);
+	}
+	Fraction operator -(const Fraction &another) const{ // this - another
+		return this->operator +(-another);
+	}
+	Fraction operator *(const Fraction &another) const{ // this * another
+		lld g1 = (lld)gcd(absolute(upnumber), another.downnumber),
+		    g2 = (lld)gcd(absolute(another.upnumber), downnumber);
+		return narrow((llld)(upnumber / g1) * (another.upnumber / g2),
+		              (llld)(downnumber / g2) * (another.downnumber / g1));
 	}
-	
+	Fraction operator /(const Fraction &another) const{ // this / another
+		if(another.upnumber == 0){
+			printf("[Fatal Error] Division by zero\n");
+			throw "Division by zero";
+		}
+		Fraction inverted(another.upnumber < 0 ? -another.downnumber : another.downnumber,
+		                  another.upnumber < 0 ? -another.upnumber : another.upnumber, Reduced());
+		return this->operator *(inverted);
+	}
+	Fraction& operator +=(const Fraction &another){return *this = *this + another;}
+	Fraction& operator -=(const Fraction &another){return *this = *this - another;}
+	Fraction& operator *=(const Fraction &another){return *this = *this * another;}
+	Fraction& operator /=(const Fraction &another){return *this = *this / another;}
+
 };
 
 int main(void){
-	
+
 	typedef long long int lld;
 	Fraction<lld> f1(27, 81);
 	auto f1pair = f1.make_pair();
 	printf("%lld / %lld\n", f1pair.first, f1pair.second);
 	printf("%.10lf\n", (double)f1);
+
+	// Harmonic number H(40) with exact arithmetic; Denominator alone exceeds 2^52.
+	Fraction<lld> harmonic(0);
+	for(lld i=1; i<=40; i++) harmonic += Fraction<lld>(1, i);
+	auto hpair = harmonic.make_pair();
+	printf("H(40) = %lld / %lld\n", hpair.first, hpair.second);
 	return 0;
 }
@@ -0,0 +1,385 @@
+/*=============================================================================
+    McDic's Competitive Programming Template / Requires C++11 or later.
+    Last edited: 2020-08-18 15:10 UTC+9
+=============================================================================*/
+
+// Custom define
+#ifdef __McDic__ // Local testing
+#define debugprintf(f_, ...) fprintf(stderr, f_, ##__VA_ARGS__)
+#define debugflush() fflush(stdout),fflush(stderr)
+#else // Submission version
+#define debugprintf(f_, ...) NULL
+#define debugflush() NULL
+#endif
+//#define raise(f_, ...) {debugprintf(f_, ##__VA_ARGS__); exit(1000);}
+//#define raiseif(condition, f_, ...) if(condition) raise(f_, ##__VA_ARGS__)
+
+// Standard libraries
+#include <stdio.h>
+#include <iostream>
+#include <chrono> // For template clock
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <map>
+#include <set>
+#include <utility>
+#include <array>
+
+// Random
+#include <random>
+std::mt19937_64 mersenne_twister(std::chrono::steady_clock::now().time_since_epoch().count());
+
+/*=============================================================================
+    Implement your own code below. 
+    To modify number of test cases, please look at Main function.
+=============================================================================*/
+
+// Linear recurrences modulo any MOD < 2^31. Like every source here this file stands alone,
+// so ntt is a copy of BigInt::ntt in big_integer.cpp; Fixes there should be mirrored here.
+namespace McDicCP{
+
+    typedef long long int lld;
+    typedef unsigned long long int llu;
+    typedef std::vector<lld> poly; // Coefficients in [0, mod), lower degree first
+
+    // Inverse of a modulo mod by extended Euclid; a should be coprime to mod.
+    lld inverse(lld a, lld mod){
+        lld b = mod, x = 1, y = 0;
+        a %= mod; if(a < 0) a += mod;
+        while(b){
+            lld q = a / b, t = a - q * b; a = b, b = t;
+            t = x - q * y; x = y, y = t;
+        }
+        if(a != 1) throw "Value is not invertible";
+        return (x % mod + mod) % mod;
+    }
+
+    // NTT over one prime with primitive root 3; a.size() should be power of 2.
+    template <unsigned int mod> void ntt(std::vector<unsigned int> &a, bool invert){
+        auto power = [](unsigned long long x, unsigned long long e) -> unsigned long long{
+            unsigned long long result = 1;
+            for(; e > 0; e >>= 1, x = x * x % mod) if(e&1) result = result * x % mod;
+            return result;
+        };
+        const size_t n = a.size();
+        for(size_t i=1, j=0; i<n; i++){
+            size_t bit = n >> 1;
+            for(; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if(i < j) std::swap(a[i], a[j]);
+        }
+        std::vector<unsigned int> w(n/2 + 1);
+        for(size_t l=2; l<=n; l<<=1){
+            unsigned long long wl = power(3, (mod-1) / l);
+            if(invert) wl = power(wl, mod-2);
+            w[0] = 1;
+            for(size_t i=1; i<l/2; i++) w[i] = (unsigned int)(w[i-1] * wl % mod);
+            for(size_t offset=0; offset<n; offset+=l){
+                unsigned int *front = &a[offset], *back = &a[offset+l/2];
+                for(size_t i=0; i<l/2; i++){
+                    unsigned int x = front[i], y = (unsigned int)((unsigned long long)back[i] * w[i] % mod);
+                    front[i] = (x + y >= mod ? x + y - mod : x + y);
+                    back[i]  = (x >= y ? x - y : x + mod - y);
+                }
+            }
+        }
+        if(invert){
+            unsigned long long ninv = power(n % mod, mod-2);
+            for(auto &x: a) x = (unsigned int)(x * ninv % mod);
+        }
+    }
+
+    // Cyclic convolution modulo MOD. 998244353 is NTT-friendly and needs one transform;
+    // Other moduli go through three NTT primes and Garner's CRT, exact while every
+    // coefficient (below 2^23 * MOD^2 < 2^85) stays under the product of primes (~2^86).
+    template <unsigned int MOD> class Convolution{
+    public:
+        static const int PRIMES = (MOD == 998244353 ? 1 : 3);
+        static const size_t MAX_LENGTH = 1 << 23; // Roots of unity of 998244353
+        typedef std::array<std::vector<unsigned int>, 3> Spectrum;
+
+        static unsigned int prime(int t){
+            static const unsigned int primes[3] = {998244353, 167772161, 469762049};
+            return primes[t];
+        }
+        static void transform(int t, std::vector<unsigned int> &a, bool invert){
+            if(t == 0) ntt<998244353>(a, invert);
+            else if(t == 1) ntt<167772161>(a, invert);
+            else ntt<469762049>(a, invert);
+        }
+
+        // Transforms of a, zero padded to len; len should be power of 2.
+        static Spectrum forward(const poly &a, size_t len){
+            if(len > MAX_LENGTH) throw "Convolution is longer than 2^23";
+            Spectrum result;
+            for(int t=0; t<PRIMES; t++){
+                result[t].assign(len, 0);
+                for(size_t i=0; i<a.size() && i<len; i++) result[t][i] = (unsigned int)(a[i] % prime(t));
+                transform(t, result[t], false);
+            }
+            return result;
+        }
+        // a *= b pointwise
+        static void pointwise(Spectrum &a, const Spectrum &b){
+            for(int t=0; t<PRIMES; t++){
+                const unsigned long long p = prime(t);
+                for(size_t i=0; i<a[t].size(); i++) a[t][i] = (unsigned int)((unsigned long long)a[t][i] * b[t][i] % p);
+            }
+        }
+        // First count coefficients of the inverse transform, modulo MOD
+        static poly backward(Spectrum a, size_t count){
+            for(int t=0; t<PRIMES; t++) transform(t, a[t], true);
+            count = std::min(count, a[0].size());
+            poly result(count);
+            if(PRIMES == 1){
+                for(size_t i=0; i<count; i++) result[i] = a[0][i];
+                return result;
+            }
+            const unsigned long long m0 = 998244353, m1 = 167772161, m2 = 469762049;
+            const unsigned long long inv01 = 47450712; // m0^-1 mod m1
+            const unsigned long long inv012 = 115990628; // (m0 m1)^-1 mod m2
+            const unsigned long long m01 = m0 * m1 % MOD;
+            for(size_t i=0; i<count; i++){
+                unsigned long long x0 = a[0][i], x1 = a[1][i], x2 = a[2][i];
+                unsigned long long v1 = (x1 + m1 - x0 % m1) % m1 * inv01 % m1;
+                unsigned long long low = x0 + m0 * v1; // Value mod m0 m1, below 2^58
+                unsigned long long v2 = (x2 + m2 - low % m2) % m2 * inv012 % m2;
+                result[i] = (lld)((low % MOD + m01 * v2) % MOD);
+            }
+            return result;
+        }
+
+        static poly multiply(const poly &a, const poly &b){
+            if(a.empty() || b.empty()) return poly();
+            const size_t need = a.size() + b.size() - 1;
+            if(std::min(a.size(), b.size()) <= 32){ // Schoolbook is faster for short operand
+                poly result(need);
+                for(size_t i=0; i<a.size(); i++) for(size_t j=0; j<b.size(); j++)
+                    result[i+j] = (result[i+j] + a[i] * b[j]) % MOD;
+                return result;
+            }
+            size_t len = 1;
+            while(len < need) len <<= 1;
+            Spectrum fa = forward(a, len);
+            pointwise(fa, forward(b, len));
+            return backward(fa, need);
+        }
+    };
+
+    // 1/a mod x^n by Newton iteration g <- g(2 - ag); a[0] should be coprime to MOD.
+    template <unsigned int MOD> poly inverseSeries(const poly &a, size_t n){
+        if(a.empty()) throw "Series is not invertible";
+        poly g = {inverse(a[0], MOD)};
+        for(size_t len=1; len<n; len<<=1){
+            poly cut(a.begin(), a.begin() + std::min(a.size(), 2*len));
+            poly ag = Convolution<MOD>::multiply(cut, g); ag.resize(2*len);
+            for(auto &x: ag) x = (x == 0 ? 0 : MOD - x);
+            ag[0] = (ag[0] + 2) % MOD;
+            g = Convolution<MOD>::multiply(g, ag); g.resize(2*len);
+        }
+        g.resize(n);
+        return g;
+    }
+
+    // Shortest c with s[n] = c[0] s[n-1] + ... + c[L-1] s[n-L] for every n >= L, in O(N^2).
+    // 2L terms determine a recurrence of order L; MOD should be prime.
+    template <unsigned int MOD> std::vector<lld> berlekampMassey(std::vector<lld> s){
+        for(auto &x: s) x = (x % MOD + MOD) % MOD;
+        poly current = {1}, previous = {1}; // Connection polynomials; 1 - c[0] x - c[1] x^2 - ...
+        lld previousDiscrepancy = 1;
+        int length = 0, shift = 1;
+        for(int n=0; n<(int)s.size(); n++, shift++){
+            lld discrepancy = 0;
+            for(int i=0; i<=length && i<(int)current.size(); i++) discrepancy = (discrepancy + current[i] * s[n-i]) % MOD;
+            if(discrepancy == 0) continue;
+            poly saved = current;
+            const lld scale = discrepancy * inverse(previousDiscrepancy, MOD) % MOD;
+            if(current.size() < previous.size() + shift) current.resize(previous.size() + shift);
+            for(size_t i=0; i<previous.size(); i++) current[i+shift] = (current[i+shift] + MOD - scale * previous[i] % MOD) % MOD;
+            if(2 * length <= n){
+                length = n + 1 - length;
+                previous = saved; previousDiscrepancy = discrepancy; shift = 0;
+            }
+        }
+        current.resize(length+1);
+        std::vector<lld> coefficients(length);
+        for(int i=0; i<length; i++) coefficients[i] = (MOD - current[i+1]) % MOD;
+        return coefficients;
+    }
+
+    // a[n] = c[0] a[n-1] + c[1] a[n-2] + ... + c[k-1] a[n-k] modulo MOD < 2^31, which need not be prime
+    // unless the recurrence is inferred by Berlekamp-Massey.
+    // a[n] is sum r[i] a[i] for r = x^n mod f, f = x^k - c[0] x^(k-1) - ... - c[k-1] (Kitamasa);
+    // Each of the O(log n) steps is an NTT square and reduction, O(k log k) instead of O(k^3) for matrix power.
+    template <unsigned int MOD = 998244353> class LinearRecurrence{
+        static_assert(2 <= MOD && MOD < (1U << 31), "Products of residues should fit in 62 bits");
+        typedef Convolution<MOD> Conv;
+        typedef typename Conv::Spectrum Spectrum;
+    private:
+        int k; size_t size; // Order, and NTT length; Every product below has fewer than size terms.
+        std::vector<lld> initial, coefficients;
+        Spectrum lowTransform, inverseTransform; // Transforms of f - x^k, and of 1/rev(f) mod x^k
+        static const size_t DENSE_LIMIT = 1 << 22; // Largest prefix computed for batched queries
+
+        // Product of a and the polynomial whose transform is given
+        poly multiplyTransformed(const poly &a, const Spectrum &transformed) const{
+            Spectrum fa = Conv::forward(a, size);
+            Conv::pointwise(fa, transformed);
+            return Conv::backward(fa, size);
+        }
+
+        // a mod f for a.size() < 2k; The quotient's reverse is rev(a) / rev(f) mod x^m.
+        poly reduce(poly a) const{
+            if((int)a.size() <= k){a.resize(k); return a;}
+            const int m = (int)a.size() - k;
+            poly quotient(a.rbegin(), a.rbegin() + m);
+            quotient = multiplyTransformed(quotient, inverseTransform);
+            quotient.resize(m); std::reverse(quotient.begin(), quotient.end());
+            poly product = multiplyTransformed(quotient, lowTransform);
+            a.resize(k);
+            for(int i=0; i<k; i++) a[i] = (a[i] >= product[i] ? a[i] - product[i] : a[i] - product[i] + MOD);
+            return a;
+        }
+
+        // x * a mod f in O(k)
+        poly shift(const poly &a) const{
+            poly result(k);
+            const lld top = a[k-1];
+            for(int i=0; i<k; i++) result[i] = ((i ? a[i-1] : 0) + top * coefficients[k-1-i]) % MOD;
+            return result;
+        }
+
+        // x^n mod f, left to right binary power
+        poly powerOfX(llu n) const{
+            poly result(k, 0); result[0] = 1 % MOD;
+            int bit = 63;
+            while(bit >= 0 && !((n >> bit) & 1)) bit--;
+            for(; bit >= 0; bit--){
+                Spectrum square = Conv::forward(result, size);
+                Conv::pointwise(square, square);
+                result = reduce(Conv::backward(square, 2*k-1));
+                if((n >> bit) & 1) result = shift(result);
+            }
+            return result;
+        }
+
+        // rev(f) = 1 - c[0] x - ... - c[k-1] x^k
+        poly reversedCharacteristic() const{
+            poly reversed(k+1, 1 % MOD);
+            for(int i=0; i<k; i++) reversed[i+1] = (MOD - coefficients[i]) % MOD;
+            return reversed;
+        }
+
+    public:
+        // initial should contain at least k = coefficients.size() terms.
+        LinearRecurrence(const std::vector<lld> &initial_, const std::vector<lld> &coefficients_):
+            k((int)coefficients_.size()), size(1), initial(initial_), coefficients(coefficients_){
+            if(initial.size() < coefficients.size()) throw "Not enough initial terms";
+            for(auto &x: initial) x = (x % MOD + MOD) % MOD;
+            for(auto &x: coefficients) x = (x % MOD + MOD) % MOD;
+            if(k == 0) return;
+            while(size < 2*(size_t)k) size <<= 1;
+            inverseTransform = Conv::forward(inverseSeries<MOD>(reversedCharacteristic(), k), size);
+            poly low(k);
+            for(int i=0; i<k; i++) low[i] = (MOD - coefficients[k-1-i]) % MOD;
+            lowTransform = Conv::forward(low, size);
+        }
+        // Recurrence inferred from the sequence by Berlekamp-Massey
+        explicit LinearRecurrence(const std::vector<lld> &sequence):
+            LinearRecurrence(sequence, berlekampMassey<MOD>(sequence)){}
+
+        int order() const{return k;}
+        const std::vector<lld> &getCoefficients() const{return coefficients;}
+
+        // a[n] in O(k log k log n)
+        lld nth(llu n) const{
+            if(n < initial.size()) return initial[n];
+            if(k == 0) return 0;
+            poly r = powerOfX(n);
+            lld result = 0;
+            for(int i=0; i<k; i++) result = (result + r[i] * initial[i]) % MOD;
+            return result;
+        }
+
+        // a[0], ..., a[count-1] in O(count log count) as power series P / rev(f)
+        std::vector<lld> terms(size_t count) const{
+            if(count <= initial.size()) return std::vector<lld>(initial.begin(), initial.begin() + count);
+            if(k == 0){
+                std::vector<lld> result(initial); result.resize(count);
+                return result;
+            }
+            poly reversed = reversedCharacteristic();
+            poly numerator = Conv::multiply(poly(initial.begin(), initial.begin() + k), reversed);
+            numerator.resize(k);
+            poly result = Conv::multiply(numerator, inverseSeries<MOD>(reversed, count));
+            result.resize(count);
+            return result;
+        }
+
+        // a[n] for every n in ns; Queries share one prefix expansion when that is cheaper
+        // than running Kitamasa for each of them.
+        std::vector<lld> nth(const std::vector<llu> &ns) const{
+            std::vector<lld> result(ns.size());
+            if(ns.empty()) return result;
+            const llu largest = *std::max_element(ns.begin(), ns.end());
+            int bits = 1;
+            while(bits < 64 && (largest >> bits)) bits++;
+            if(largest < DENSE_LIMIT && largest <= (llu)ns.size() * std::max(k, 1) * bits){
+                std::vector<lld> prefix = terms(largest+1);
+                for(size_t i=0; i<ns.size(); i++) result[i] = prefix[ns[i]];
+            }
+            else for(size_t i=0; i<ns.size(); i++) result[i] = nth(ns[i]);
+            return result;
+        }
+    };
+
+    // Main solver function
+    void solve(){
+
+        // Infer the recurrence from m terms modulo 10^9+7, same modulus as matrix_power.cpp,
+        // then answer q term queries
+        int m; scanf("%d", &m);
+        std::vector<lld> sequence(m);
+        for(int i=0; i<m; i++) scanf("%lld", &sequence[i]);
+        LinearRecurrence<1000000007> recurrence(sequence);
+        debugprintf("Order %d\n", recurrence.order());
+        int q; scanf("%d", &q);
+        std::vector<llu> ns(q);
+        for(int i=0; i<q; i++) scanf("%llu", &ns[i]);
+        std::vector<lld> values = recurrence.nth(ns);
+        for(int i=0; i<q; i++) printf("%lld\n", values[i]);
+    }
+
+}
+
+/*=============================================================================
+    int main();
+=============================================================================*/
+
+// Main
+int main(int argc, char **argv){
+#ifdef __McDic__ // Local testing
+    freopen("IO/input.txt", "r", stdin);
+    printf("================================================\n");
+    printf(" McDic's C++17 file execution for CP\n");
+    printf("================================================\n");
+    freopen("IO/output.txt", "w", stdout);
+    freopen("IO/debug.txt", "w", stderr);
+    auto startedTime = std::chrono::steady_clock::now();
+#endif
+
+    int testcases = 1; 
+    //std::cin >> testcases;
+    for(int t=1; t<=testcases; t++) McDicCP::solve();
+
+#ifdef __McDic__ // Local testing
+    auto endTime = std::chrono::steady_clock::now();
+    std::chrono::duration<double> duration = endTime - startedTime;
+    debugprintf("\n"); for(int i=0; i<80; i++) debugprintf("="); debugprintf("\n");
+    debugprintf("Total %.8lf ms used.\n", duration.count());
+#endif
+    return 0;
+}
\ No newline at end of file
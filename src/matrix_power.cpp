@@ -6,51 +6,169 @@
 #include <stdio.h>
 #include <assert.h>
 #include <vector>
+#include <algorithm>
+#include <thread>
+#include "thread_pool.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 // Shorter name
 typedef long long int lld;
-lld R = 1000 * 1000 * 1000 + 7;
+const unsigned int R = 1000 * 1000 * 1000 + 7;
 
-// Matrix class
-class squarematrix{
+// Modular integer with compile-time modulus M <= 2^31; Every % has a constant divisor,
+// so the compiler turns it into multiplications.
+template <unsigned int M> class ModInt{
+	static_assert(1 <= M && M <= (1U << 31), "Sum of two residues should fit in 32 bits");
+public:
+	unsigned int value;
+	constexpr ModInt(): value(0){}
+	constexpr ModInt(lld x): value((unsigned int)(x % (lld)M < 0 ? x % (lld)M + M : x % (lld)M)){}
+	static constexpr unsigned int modulus(){return M;}
+	constexpr explicit operator lld() const{return value;}
+
+	ModInt &operator +=(const ModInt &another){value += another.value; if(value >= M) value -= M; return *this;}
+	ModInt &operator -=(const ModInt &another){value += M - another.value; if(value >= M) value -= M; return *this;}
+	ModInt &operator *=(const ModInt &another){value = (unsigned int)((unsigned long long)value * another.value % M); return *this;}
+	ModInt &operator /=(const ModInt &another){return *this *= another.inverse();}
+	ModInt operator -() const{return ModInt() -= *this;}
+	friend ModInt operator +(ModInt a, const ModInt &b){return a += b;}
+	friend ModInt operator -(ModInt a, const ModInt &b){return a -= b;}
+	friend ModInt operator *(ModInt a, const ModInt &b){return a *= b;}
+	friend ModInt operator /(ModInt a, const ModInt &b){return a /= b;}
+	friend constexpr bool operator ==(const ModInt &a, const ModInt &b){return a.value == b.value;}
+	friend constexpr bool operator !=(const ModInt &a, const ModInt &b){return a.value != b.value;}
+
+	ModInt pow(unsigned long long n) const{
+		ModInt result(1), x = *this;
+		for(; n; n >>= 1, x *= x) if(n&1) result *= x;
+		return result;
+	}
+	// Extended Euclid; value should be coprime to M
+	ModInt inverse() const{
+		lld a = value, b = M, x = 1, y = 0;
+		while(b){
+			lld q = a / b, t = a - q * b; a = b, b = t;
+			t = x - q * y; x = y, y = t;
+		}
+		return ModInt(x);
+	}
+};
+
+// Worker threads for matrix multiplication; Rows of the result are split between them.
+unsigned int THREADS = std::max(1U, std::thread::hardware_concurrency());
+const int ROWS_PER_THREAD = 32; // Smaller products stay on the calling thread
+
+// Call work(rowBegin, rowEnd) over [0, n) in contiguous chunks on up to THREADS pooled threads
+template <typename Work> void parallelRows(int n, Work work){
+	const int threads = (int)std::min<lld>(THREADS, std::max(1, n / ROWS_PER_THREAD));
+	if(threads == 1){work(0, n); return;}
+	sharedPool().run(threads, [&](unsigned int t){work((int)((lld)n * t / threads), (int)((lld)n * (t+1) / threads));});
+}
+
+// c = a * b for n x n row-major arrays, i-k-j order so both b and c are read along rows
+template <typename T> void multiplyInto(const T *a, const T *b, T *c, int n){
+	parallelRows(n, [=](int rowBegin, int rowEnd){
+		for(int i=rowBegin; i<rowEnd; i++){
+			T *crow = c + (size_t)i * n;
+			for(int j=0; j<n; j++) crow[j] = T(0);
+			for(int k=0; k<n; k++){
+				const T aik = a[(size_t)i * n + k];
+				const T *brow = b + (size_t)k * n;
+				for(int j=0; j<n; j++) crow[j] += aik * brow[j];
+			}
+		}
+	});
+}
+
+// accumulator[j] += a0 * b0[j] + a1 * b1[j] + a2 * b2[j] + a3 * b3[j] for j < n;
+// With AVX2, four 32-bit b values are widened to 64-bit lanes and multiplied by vpmuludq.
+inline void accumulateRows(unsigned long long *accumulator, int n, const unsigned int *a, const unsigned int *b0,
+	const unsigned int *b1, const unsigned int *b2, const unsigned int *b3){
+	int j = 0;
+#ifdef __AVX2__
+	const __m256i a0 = _mm256_set1_epi64x(a[0]), a1 = _mm256_set1_epi64x(a[1]), a2 = _mm256_set1_epi64x(a[2]), a3 = _mm256_set1_epi64x(a[3]);
+	auto widen = [](const unsigned int *p){return _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)p));};
+	for(; j+4<=n; j+=4){
+		__m256i sum = _mm256_loadu_si256((const __m256i*)(accumulator + j));
+		sum = _mm256_add_epi64(sum, _mm256_mul_epu32(a0, widen(b0 + j)));
+		sum = _mm256_add_epi64(sum, _mm256_mul_epu32(a1, widen(b1 + j)));
+		sum = _mm256_add_epi64(sum, _mm256_mul_epu32(a2, widen(b2 + j)));
+		sum = _mm256_add_epi64(sum, _mm256_mul_epu32(a3, widen(b3 + j)));
+		_mm256_storeu_si256((__m256i*)(accumulator + j), sum);
+	}
+#endif
+	for(; j<n; j++) accumulator[j] += (unsigned long long)a[0] * b0[j] + (unsigned long long)a[1] * b1[j]
+		+ (unsigned long long)a[2] * b2[j] + (unsigned long long)a[3] * b3[j];
+}
+
+// Same for ModInt<M>, with delayed reduction; Products are summed in 64 bits
+// and reduced only once every BLOCK terms, the most that cannot overflow.
+template <unsigned int M> void multiplyInto(const ModInt<M> *a, const ModInt<M> *b, ModInt<M> *c, int n){
+	static_assert(sizeof(ModInt<M>) == sizeof(unsigned int), "Rows are read as raw 32-bit residues");
+	const unsigned int *A = (const unsigned int*)a, *B = (const unsigned int*)b;
+	const unsigned long long maxProduct = (unsigned long long)(M-1) * (M-1);
+	const int BLOCK = maxProduct == 0 ? n : (int)std::min((unsigned long long)n, (~0ULL - (M-1)) / maxProduct);
+	parallelRows(n, [=](int rowBegin, int rowEnd){
+		std::vector<unsigned long long> accumulator(n);
+		for(int i=rowBegin; i<rowEnd; i++){
+			const unsigned int *arow = A + (size_t)i * n;
+			std::fill(accumulator.begin(), accumulator.end(), 0);
+			for(int k0=0; k0<n; k0+=BLOCK){
+				const int k1 = std::min(n, k0+BLOCK);
+				int k = k0;
+				for(; k+4<=k1; k+=4){ // Four rows of b per pass over accumulator
+					const unsigned int *b0 = B + (size_t)k * n;
+					accumulateRows(accumulator.data(), n, arow + k, b0, b0 + n, b0 + 2*n, b0 + 3*n);
+				}
+				for(; k<k1; k++){
+					const unsigned long long aik = arow[k];
+					const unsigned int *brow = B + (size_t)k * n;
+					for(int j=0; j<n; j++) accumulator[j] += aik * brow[j];
+				}
+				for(int j=0; j<n; j++) accumulator[j] %= M;
+			}
+			for(int j=0; j<n; j++) c[(size_t)i * n + j].value = (unsigned int)accumulator[j];
+		}
+	});
+}
+
+// Matrix class; T is the element type, such as ModInt<R>
+// Elements are stored row-major in one array, and mat[i][j] works through row pointers.
+template <typename T> class squarematrix{
 public:
 	
 	// Attributes
-	std::vector<std::vector<lld>> mat;
+	int size;
+	std::vector<T> data;
 	
 	// Constructors
-	squarematrix(int size, bool shouldI = true){ // Elementary matrix constructor
-		this->mat = std::vector<std::vector<lld>>(size);
+	squarematrix(int size, bool shouldI = true): size(size), data((size_t)size * size, T(0)){ // Elementary matrix constructor
+		if(shouldI) for(int i=0; i<size; i++) (*this)[i][i] = T(1); // shouldI = true -> I, false -> ZERO
+	}
+	squarematrix(const std::vector<std::vector<T>> &anothermat): squarematrix(anothermat.size(), false){ // Vector copy constructor; Must be square
 		for(int i=0; i<size; i++){
-			this->mat[i] = std::vector<lld>(size, 0);
-			if(shouldI) this->mat[i][i] = 1; // shouldI = true -> I, false -> ZERO
+			assert(i < (int)anothermat.size() && (int)anothermat[i].size() == size); // Row exists with exactly size elements
+			std::copy(anothermat[i].begin(), anothermat[i].begin() + size, (*this)[i]);
 		}
 	}
-	squarematrix(const std::vector<std::vector<lld>> &anothermat){ // Vector copy constructor; Must be square
-		this->mat = anothermat;
-		for(int i=0; i<this->mat.size(); i++) // Size assertion
-			assert(this->mat.size() == this->mat[i].size());
-	}
+	
+	// Row access
+	T *operator [](int row){return data.data() + (size_t)row * size;}
+	const T *operator [](int row) const{return data.data() + (size_t)row * size;}
 	
 	// Multiplication
-	squarematrix operator *(const squarematrix &another){
-		assert(this->mat.size() == another.mat.size());
-		int size = this->mat.size();
+	squarematrix operator *(const squarematrix &another) const{
+		assert(this->size == another.size);
 		squarematrix result = squarematrix(size, false);
-		for(int row=0; row<size; row++){
-			for(int col=0; col<size; col++){
-				for(int k=0; k<size; k++){
-					result.mat[row][col] += this->mat[row][k] * another.mat[k][col];
-					result.mat[row][col] %= R;
-				}
-			}
-		}
+		multiplyInto(this->data.data(), another.data.data(), result.data.data(), size);
 		return result;
 	}
 	
 	// Power
-	squarematrix power(lld p){ // this ^ p % R
-		if(p==0) return squarematrix(this->mat.size());
+	squarematrix power(lld p) const{ // this ^ p
+		if(p==0) return squarematrix(this->size);
 		squarematrix half = this->power(p>>1);
 		if(p%2==0) return half*half;
 		else return half*half*(*this);
@@ -64,20 +182,24 @@ int main(void){
 	int n; scanf("%d", &n);
 	
 	// Input by row
-	squarematrix mat = squarematrix(n);
+	typedef ModInt<R> mint;
+	squarematrix<mint> mat = squarematrix<mint>(n);
 	for(int i=0; i<n; i++){
 		printf("Input %d numbers for %d-th row: ", n, i+1);
-		for(int j=0; j<n; j++) scanf("%lld", &mat.mat[i][j]);
+		for(int j=0; j<n; j++){
+			lld value; scanf("%lld", &value);
+			mat[i][j] = value;
+		}
 	}
 	
 	// Get power
 	printf("Input the power you want: ");
 	lld p; scanf("%lld", &p); assert(p >= 0);
-	squarematrix powered = mat.power(p);
+	squarematrix<mint> powered = mat.power(p);
 	printf("Powered result:\n");
 	for(int i=0; i<n; i++){
 		printf("  "); 
-		for(int j=0; j<n; j++) printf("%10lld ", powered.mat[i][j]);
+		for(int j=0; j<n; j++) printf("%10u ", powered[i][j].value);
 		printf("\n");
 	}
 	return 0;
@@ -26,6 +26,12 @@
 #include <map>
 #include <set>
 #include <utility>
+#include <memory>
+
+// SIMD
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 // Random
 #include <random>
@@ -40,44 +46,312 @@ namespace McDicCP{
 
     typedef unsigned long long int lld;
 
-    lld pow(const lld a, lld x, const lld mod){
-        if(x==0) return 1;
-        lld half = pow(a, x>>1, mod);
-        if(x&1) return half * half % mod * a % mod;
-        else return half * half % mod;
+    // Montgomery multiplication modulo odd n; Values are kept as aR mod n with R = 2^64.
+    struct Montgomery{
+        lld n, inv, r2; // n * inv = 1 mod 2^64, r2 = R^2 mod n
+        Montgomery(lld n = 1): n(n), inv(n){
+            for(int i=0; i<5; i++) inv *= 2 - n * inv; // Each Newton step doubles correct low bits
+            r2 = (lld)(-(unsigned __int128)n % n);
+        }
+        // tR^(-1) mod n for t < nR; Low halves of t and m*n cancel, so only high halves are subtracted.
+        lld reduce(unsigned __int128 t) const{
+            lld m = (lld)t * inv, high = (lld)(t >> 64), mn = (lld)(((unsigned __int128)m * n) >> 64);
+            return high >= mn ? high - mn : high - mn + n;
+        }
+        lld multiply(lld a, lld b) const{return reduce((unsigned __int128)a * b);}
+        lld to(lld a) const{return multiply(a % n, r2);}
+        lld from(lld a) const{return reduce(a);}
+        lld power(lld a, lld x) const{ // a in Montgomery form
+            lld result = to(1);
+            for(; x; x >>= 1, a = multiply(a, a)) if(x&1) result = multiply(result, a);
+            return result;
+        }
+    };
+
+    // Jim Sinclair's bases; Deterministic for every n < 2^64.
+    const lld BASES[7] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+    // Decide small or even n by trial division; Returns 0 if composite, 1 if prime, -1 if undecided.
+    int trivialPrimality(lld n){
+        const lld small[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+        if(n < 2) return 0;
+        #pragma GCC unroll 12 // Constant divisors become multiplications
+        for(lld p: small) if(n % p == 0) return n == p;
+        return n < 41 * 41 ? 1 : -1;
     }
 
     // https://en.wikipedia.org/wiki/Miller%E2%80%93Rabin_primality_test
-    // Return true if (maybe) prime, false if composite.
+    // Return true if prime, false if composite.
     bool MillerRabinPrimality(lld n){
 
+        int trivial = trivialPrimality(n);
+        if(trivial >= 0) return trivial;
         lld r = 0, d = n-1; // n = 2**r * d + 1
         while(!(d&1)) r++, d>>=1;
-        debugprintf("MillerRabin: n = %lld, r = %lld, d = %lld\n", n, r, d);
-
-        lld a_candidates[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
-        for(lld a: a_candidates){
-            if(n == a) return true;
-            lld x = pow(a%n, d, n);
-            if(x==1) continue;
-            for(int i=1; i<r && x != n-1; i++) x = x * x % n;
-            if(x == n-1) continue;
+        debugprintf("MillerRabin: n = %llu, r = %llu, d = %llu\n", n, r, d);
+
+        const Montgomery mont(n);
+        const lld one = mont.to(1), minusOne = mont.to(n-1);
+        for(lld a: BASES){
+            if(a % n == 0) continue;
+            lld x = mont.power(mont.to(a), d);
+            if(x == one || x == minusOne) continue;
+            for(lld i=1; i<r && x != minusOne; i++) x = mont.multiply(x, x);
+            if(x == minusOne) continue;
             else return false; // composite
         }
-        return true; // Maybe prime
+        return true;
+    }
+
+    // Run given bases on values[pending[...]] LANES at a time in lockstep, so independent
+    // Montgomery products overlap their multiply latency. Composites get false in results,
+    // and only values passing every base are kept in pending.
+    void MillerRabinLanes(const lld *values, std::vector<size_t> &pending, const lld *bases, int baseCount, bool *results){
+        const int LANES = 4;
+        size_t kept = 0;
+        for(size_t start=0; start<pending.size(); start+=LANES){
+            Montgomery mont[LANES];
+            lld d[LANES], r[LANES], one[LANES], minusOne[LANES], x[LANES], base[LANES], table[LANES][16];
+            bool composite[LANES] = {}, passed[LANES];
+            lld maxD = 0, maxR = 0;
+            for(int l=0; l<LANES; l++){ // Last group is padded by repeating its final value
+                const lld n = values[pending[std::min(start + l, pending.size() - 1)]];
+                mont[l] = Montgomery(n);
+                d[l] = n-1, r[l] = 0;
+                while(!(d[l]&1)) r[l]++, d[l]>>=1;
+                one[l] = mont[l].to(1), minusOne[l] = mont[l].to(n-1);
+                maxD = std::max(maxD, d[l]), maxR = std::max(maxR, r[l]);
+            }
+            const int bits = 64 - __builtin_clzll(maxD);
+            for(int b=0; b<baseCount; b++){
+
+                // Fixed 4-bit windows from the top, so every lane runs the same sequence;
+                // Leading zero windows of shorter exponents keep x at one.
+                for(int l=0; l<LANES; l++){
+                    base[l] = mont[l].to(bases[b]);
+                    table[l][0] = one[l];
+                    for(int k=1; k<16; k++) table[l][k] = mont[l].multiply(table[l][k-1], base[l]);
+                    x[l] = one[l];
+                }
+                for(int shift=(bits+3)/4*4-4; shift>=0; shift-=4){
+                    for(int l=0; l<LANES; l++){
+                        lld y = x[l];
+                        for(int k=0; k<4; k++) y = mont[l].multiply(y, y);
+                        x[l] = mont[l].multiply(y, table[l][d[l] >> shift & 15]);
+                    }
+                }
+
+                for(int l=0; l<LANES; l++) passed[l] = base[l] == 0 || x[l] == one[l] || x[l] == minusOne[l];
+                for(lld i=1; i<maxR; i++){
+                    for(int l=0; l<LANES; l++){
+                        lld square = mont[l].multiply(x[l], x[l]);
+                        if(!passed[l] && i < r[l]) x[l] = square, passed[l] = square == minusOne[l];
+                    }
+                }
+                bool allComposite = true;
+                for(int l=0; l<LANES; l++) composite[l] |= !passed[l], allComposite &= composite[l];
+                if(allComposite) break;
+            }
+            for(int l=0; l<LANES && start+l<pending.size(); l++){
+                if(composite[l]) results[pending[start+l]] = false;
+                else pending[kept++] = pending[start+l];
+            }
+        }
+        pending.resize(kept);
+    }
+
+    // Test values[0..count) and write results.
+    // Base 2 alone rejects almost every composite, so it runs first over the whole batch
+    // and the other bases only see its survivors.
+    void MillerRabinBatch(const lld *values, size_t count, bool *results){
+        std::vector<size_t> pending;
+        for(size_t i=0; i<count; i++){
+            int trivial = trivialPrimality(values[i]);
+            if(trivial >= 0) results[i] = trivial;
+            else pending.push_back(i);
+        }
+        MillerRabinLanes(values, pending, BASES, 1, results);
+        MillerRabinLanes(values, pending, BASES + 1, 6, results);
+        for(size_t i: pending) results[i] = true;
+    }
+
+    // Bases {2, 7, 61} are deterministic below 4759123141, so they cover every 32-bit n.
+    const unsigned int BASES32[3] = {2, 7, 61};
+
+    // Scalar primality for 32-bit n; Same as MillerRabinPrimality but only 3 bases.
+    bool MillerRabin32(unsigned int n){
+        int trivial = trivialPrimality(n);
+        if(trivial >= 0) return trivial;
+        unsigned int r = 0, d = n-1;
+        while(!(d&1)) r++, d>>=1;
+        const Montgomery mont(n);
+        const lld one = mont.to(1), minusOne = mont.to(n-1);
+        for(unsigned int a: BASES32){
+            lld x = mont.power(mont.to(a), d);
+            if(x == one || x == minusOne) continue;
+            for(unsigned int i=1; i<r && x != minusOne; i++) x = mont.multiply(x, x);
+            if(x != minusOne) return false;
+        }
+        return true;
+    }
+
+#ifdef __AVX2__
+    // Montgomery with R = 2^32 in each 64-bit lane; n < 2^32 is odd and n * inv = 1 mod 2^32.
+    struct MontgomeryLanes{
+        __m256i n, inv;
+        // abR^(-1) mod n for ab < nR; Low 32 bits of ab and mn agree, so only high halves are subtracted.
+        __m256i multiply(__m256i a, __m256i b) const{
+            __m256i t = _mm256_mul_epu32(a, b);
+            __m256i m = _mm256_mul_epu32(t, inv);
+            __m256i mn = _mm256_mul_epu32(m, n);
+            __m256i diff = _mm256_sub_epi64(_mm256_srli_epi64(t, 32), _mm256_srli_epi64(mn, 32));
+            return _mm256_add_epi64(diff, _mm256_and_si256(n, _mm256_cmpgt_epi64(_mm256_setzero_si256(), diff)));
+        }
+    };
+#endif
+
+#ifdef __AVX2__
+    // Run given bases on values[pending[...]] as two interleaved vectors of 4 lanes.
+    // Composites get false in results, and only values passing every base are kept in pending.
+    void MillerRabinLanes32(const unsigned int *values, std::vector<size_t> &pending, const unsigned int *bases, int baseCount, bool *results){
+        const int VECTORS = 2, LANES = 4 * VECTORS;
+        size_t kept = 0;
+        for(size_t start=0; start<pending.size(); start+=LANES){
+            alignas(32) lld n[LANES], inv[LANES], d[LANES], r[LANES], one[LANES], r2[LANES];
+            lld maxD = 0, maxR = 0;
+            for(int l=0; l<LANES; l++){ // Last group is padded by repeating its final value
+                n[l] = values[pending[std::min(start + l, pending.size() - 1)]];
+                unsigned int nInv = (unsigned int)n[l];
+                for(int i=0; i<4; i++) nInv *= 2 - (unsigned int)n[l] * nInv;
+                inv[l] = nInv;
+                d[l] = n[l]-1, r[l] = 0;
+                while(!(d[l]&1)) r[l]++, d[l]>>=1;
+                one[l] = (1ULL << 32) % n[l], r2[l] = one[l] * one[l] % n[l];
+                maxD = std::max(maxD, d[l]), maxR = std::max(maxR, r[l]);
+            }
+            MontgomeryLanes mont[VECTORS];
+            __m256i exponent[VECTORS], rounds[VECTORS], oneV[VECTORS], minusOneV[VECTORS], rSquared[VECTORS], composite[VECTORS];
+            for(int v=0; v<VECTORS; v++){
+                mont[v].n = _mm256_load_si256((const __m256i*)(n + 4*v));
+                mont[v].inv = _mm256_load_si256((const __m256i*)(inv + 4*v));
+                exponent[v] = _mm256_load_si256((const __m256i*)(d + 4*v));
+                rounds[v] = _mm256_load_si256((const __m256i*)(r + 4*v));
+                oneV[v] = _mm256_load_si256((const __m256i*)(one + 4*v));
+                minusOneV[v] = _mm256_sub_epi64(mont[v].n, oneV[v]);
+                rSquared[v] = _mm256_load_si256((const __m256i*)(r2 + 4*v));
+                composite[v] = _mm256_setzero_si256();
+            }
+            const __m256i lowBit = _mm256_set1_epi64x(1);
+            const int bits = 64 - __builtin_clzll(maxD);
+            for(int b=0; b<baseCount; b++){
+                const unsigned int a = bases[b];
+                __m256i base[VECTORS], x[VECTORS], passed[VECTORS];
+                for(int v=0; v<VECTORS; v++){
+                    base[v] = mont[v].multiply(_mm256_set1_epi64x(a), rSquared[v]);
+                    x[v] = oneV[v];
+                }
+
+                // Square, multiply, then keep the product only in lanes whose exponent bit is set
+                for(int bit=bits-1; bit>=0; bit--){
+                    const __m256i shift = _mm256_set1_epi64x(bit);
+                    for(int v=0; v<VECTORS; v++){
+                        x[v] = mont[v].multiply(x[v], x[v]);
+                        __m256i product = mont[v].multiply(x[v], base[v]);
+                        __m256i take = _mm256_cmpeq_epi64(_mm256_and_si256(_mm256_srlv_epi64(exponent[v], shift), lowBit), lowBit);
+                        x[v] = _mm256_blendv_epi8(x[v], product, take);
+                    }
+                }
+
+                for(int v=0; v<VECTORS; v++) passed[v] = _mm256_or_si256(_mm256_cmpeq_epi64(x[v], oneV[v]), _mm256_cmpeq_epi64(x[v], minusOneV[v]));
+                for(lld i=1; i<maxR; i++){
+                    const __m256i step = _mm256_set1_epi64x(i);
+                    for(int v=0; v<VECTORS; v++){
+                        x[v] = mont[v].multiply(x[v], x[v]);
+                        __m256i hit = _mm256_and_si256(_mm256_cmpgt_epi64(rounds[v], step), _mm256_cmpeq_epi64(x[v], minusOneV[v]));
+                        passed[v] = _mm256_or_si256(passed[v], hit);
+                    }
+                }
+                int allComposite = 1;
+                for(int v=0; v<VECTORS; v++){
+                    composite[v] = _mm256_or_si256(composite[v], _mm256_andnot_si256(passed[v], _mm256_set1_epi64x(-1)));
+                    allComposite &= _mm256_movemask_pd(_mm256_castsi256_pd(composite[v])) == 15;
+                }
+                if(allComposite) break;
+            }
+            for(int v=0; v<VECTORS; v++){
+                int mask = _mm256_movemask_pd(_mm256_castsi256_pd(composite[v]));
+                for(int l=0; l<4 && start+4*v+l<pending.size(); l++){
+                    if(mask >> l & 1) results[pending[start+4*v+l]] = false;
+                    else pending[kept++] = pending[start+4*v+l];
+                }
+            }
+        }
+        pending.resize(kept);
+    }
+#endif
+
+    // Test 32-bit values[0..count) and write results.
+    // With AVX2, base 2 runs over the whole batch first 8 candidates at a time,
+    // and bases 7 and 61 only see its survivors; Otherwise every value goes through MillerRabin32.
+    void MillerRabinBatch32(const unsigned int *values, size_t count, bool *results){
+        std::vector<size_t> pending;
+        for(size_t i=0; i<count; i++){
+            int trivial = trivialPrimality(values[i]);
+            if(trivial >= 0) results[i] = trivial;
+            else pending.push_back(i);
+        }
+#ifdef __AVX2__
+        MillerRabinLanes32(values, pending, BASES32, 1, results);
+        MillerRabinLanes32(values, pending, BASES32 + 1, 2, results);
+        for(size_t i: pending) results[i] = true;
+#else
+        for(size_t i: pending) results[i] = MillerRabin32(values[i]);
+#endif
     }
 
+#ifdef __McDic_benchmark__ // 32-bit batch throughput
+    // Candidates 2s+1 for s below 10^8, scalar against batch, in chunks to bound memory.
+    void benchmarkBatch32(){
+        const unsigned int total = 100000000, CHUNK = 1 << 16;
+        std::vector<unsigned int> chunk(CHUNK);
+        std::unique_ptr<bool[]> prime(new bool[CHUNK]);
+        for(int method=0; method<2; method++){
+            unsigned int found = 0;
+            auto start = std::chrono::steady_clock::now();
+            for(unsigned int s=0; s<total; s+=CHUNK){
+                const unsigned int len = std::min(CHUNK, total - s);
+                for(unsigned int i=0; i<len; i++) chunk[i] = 2*(s+i)+1;
+                if(method == 0) for(unsigned int i=0; i<len; i++) prime[i] = MillerRabin32(chunk[i]);
+                else MillerRabinBatch32(chunk.data(), len, prime.get());
+                for(unsigned int i=0; i<len; i++) found += prime[i];
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            printf("%s: %u primes, %.3f s, %.1f ns per candidate\n",
+                method == 0 ? "scalar" : "batch ", found, elapsed.count(), 1e9 * elapsed.count() / total);
+        }
+    }
+#endif
+
     // Main solver function
     void solve(){
 
         int n; std::cin >> n;
-        int ans = 0;
-        while(n--){
+        std::vector<lld> candidates(n);
+        for(int i=0; i<n; i++){
             lld s; std::cin >> s;
-            //if(MillerRabinCPAlgo::MillerRabin(2*s+1)){
-            if(MillerRabinPrimality(2*s+1)){
+            candidates[i] = 2*s+1;
+        }
+        std::unique_ptr<bool[]> prime(new bool[candidates.size()]);
+        if(std::all_of(candidates.begin(), candidates.end(), [](lld c){return c < (1ULL << 32);})){
+            std::vector<unsigned int> narrow(candidates.begin(), candidates.end());
+            MillerRabinBatch32(narrow.data(), n, prime.get());
+        }
+        else MillerRabinBatch(candidates.data(), n, prime.get());
+        int ans = 0;
+        for(int i=0; i<n; i++){
+            if(prime[i]){
                 ans++;
-                debugprintf("Candidate: %lld\n", s);
+                debugprintf("Candidate: %llu\n", (candidates[i]-1)/2);
             }
         }
         printf("%d\n", ans);
@@ -91,6 +365,10 @@ namespace McDicCP{
 
 // Main
 int main(int argc, char **argv){
+#ifdef __McDic_benchmark__
+    McDicCP::benchmarkBatch32();
+    return 0;
+#endif
 #ifdef __McDic__ // Local testing
     freopen("IO/input.txt", "r", stdin);
     printf("================================================\n");
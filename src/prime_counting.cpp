@@ -0,0 +1,212 @@
+/*=============================================================================
+    McDic's Competitive Programming Template / Requires C++11 or later.
+    Last edited: 2020-08-18 15:10 UTC+9
+=============================================================================*/
+
+// Custom define
+#ifdef __McDic__ // Local testing
+#define debugprintf(f_, ...) fprintf(stderr, f_, ##__VA_ARGS__)
+#define debugflush() fflush(stdout),fflush(stderr)
+#else // Submission version
+#define debugprintf(f_, ...) NULL
+#define debugflush() NULL
+#endif
+//#define raise(f_, ...) {debugprintf(f_, ##__VA_ARGS__); exit(1000);}
+//#define raiseif(condition, f_, ...) if(condition) raise(f_, ##__VA_ARGS__)
+
+// Standard libraries
+#include <stdio.h>
+#include <iostream>
+#include <chrono> // For template clock
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <map>
+#include <set>
+#include <utility>
+
+// Random
+#include <random>
+std::mt19937_64 mersenne_twister(std::chrono::steady_clock::now().time_since_epoch().count());
+
+/*=============================================================================
+    Implement your own code below. 
+    To modify number of test cases, please look at Main function.
+=============================================================================*/
+
+namespace McDicCP{
+
+    typedef long long int lld;
+    typedef unsigned long long int llu;
+    typedef __int128 lll;
+
+    llu isqrt(llu x){
+        llu r = (llu)sqrtl((long double)x);
+        while(r * r > x) r--;
+        while((r+1) * (r+1) <= x) r++;
+        return r;
+    }
+
+    // Odd primes up to limit by plain odd-only sieve; Lucy's recurrence only needs
+    // primes up to sqrt(n), a few million at most, so no segmentation is needed.
+    std::vector<llu> oddPrimes(llu limit){
+        std::vector<llu> result;
+        std::vector<char> composite(limit/2 + 1, 0); // composite[i] for 2i+1
+        for(llu i=3; i<=limit; i+=2){
+            if(composite[i/2]) continue;
+            result.push_back(i);
+            for(llu j=i*i; j<=limit; j+=2*i) composite[j/2] = 1;
+        }
+        return result;
+    }
+
+    // Weights for Lucy's recurrence. Each policy describes a completely multiplicative f
+    // by f(p) and F(v) = sum of f(k) over odd k in [3, v].
+    // small holds F(v) for v <= sqrt(n), large holds F(n / i).
+    struct CountPolicy{
+        typedef lld small;
+        typedef lld large;
+        static lld weight(llu){return 1;}
+        static lld initial(llu v){return (lld)((v - 1) / 2);}
+    };
+    struct SumPolicy{
+        typedef lld small;  // Sums up to sqrt(n) stay below 2^63 for n < 2^60
+        typedef lll large;
+        static lld weight(llu p){return (lld)p;}
+        static lll initial(llu v){lll m = (v + 1) / 2; return m * m - 1;}
+    };
+
+    // floor(n / d); Doubles are exact enough below 2^53 and much faster than 64-bit division.
+    inline llu divide(llu n, llu d){
+        return n < (1ULL << 53) ? (llu)((double)n / (double)d) : n / d;
+    }
+
+    // Lucy_Hedgehog's sieve over odd numbers; Returns sum of f(p) for odd primes p <= n.
+    // Only n / i for i coprime to every sieved prime are kept, since no other quotient
+    // is read again. Primes above n^(1/4) cannot change the small table, so from there
+    // only 1 and primes remain in the list and each step touches i <= n / p^2.
+    // Time is about O(n^(3/4) / log n) and memory O(sqrt(n)).
+    template <typename Policy> typename Policy::large lucy(llu n){
+        typedef typename Policy::small small;
+        typedef typename Policy::large large;
+        if(n < 3) return 0;
+        const llu root = isqrt(n);
+        auto half = [](llu v) -> size_t {return (size_t)((v - 1) >> 1);}; // Index of odd number <= v
+
+        // smalls[j] = F(2j+1), larges[k] = F(n / roughs[k]), position[j] = k where roughs[k] = 2j+1
+        const size_t oddCount = half(root) + 1;
+        std::vector<small> smalls(oddCount);
+        std::vector<large> larges(oddCount);
+        std::vector<llu> roughs(oddCount);
+        std::vector<unsigned int> position(oddCount);
+        std::vector<char> removed(oddCount, 0);
+        for(size_t j=0; j<oddCount; j++){
+            smalls[j] = (small)Policy::initial(2*j+1);
+            roughs[j] = 2*j+1, position[j] = (unsigned int)j;
+            larges[j] = Policy::initial(divide(n, 2*j+1));
+        }
+
+        const std::vector<llu> primes = oddPrimes(root);
+        size_t s = oddCount, pi = 0;
+
+        // Phase 1: p^2 <= root, every quotient and small value can change
+        for(; pi < primes.size() && primes[pi] * primes[pi] <= root; pi++){
+            const llu p = primes[pi];
+            const small fp = (small)Policy::weight(p), below = smalls[half(p-1)];
+            const llu limit = n / p / p;
+            removed[half(p)] = 1;
+            for(llu m = p*p; m <= root; m += 2*p) removed[half(m)] = 1;
+
+            size_t kept = 0;
+            for(size_t k=0; k<s; k++){
+                const llu i = roughs[k];
+                if(removed[half(i)]) continue;
+                large value = larges[k];
+                if(i <= limit){
+                    const llu d = i * p;
+                    const large quotient = d <= root ? larges[position[half(d)]] : (large)smalls[half(divide(n, d))];
+                    value -= (large)fp * (quotient - (large)below);
+                }
+                larges[kept] = value;
+                roughs[kept] = i, position[half(i)] = (unsigned int)kept;
+                kept++;
+            }
+            s = kept;
+
+            // F(v) -= f(p) * (F(v / p) - F(p - 1)), one block of equal v / p at a time
+            size_t top = half(root);
+            for(llu j = ((root / p) - 1) | 1; j >= p; j -= 2){
+                const small c = fp * (smalls[j >> 1] - below);
+                for(size_t e = (size_t)((j * p) >> 1); top >= e; top--) smalls[top] -= c;
+            }
+        }
+
+        // Phase 2: roughs is 1 followed by the remaining primes, smalls is final
+        for(; pi < primes.size(); pi++){
+            const llu p = primes[pi];
+            const small fp = (small)Policy::weight(p), below = smalls[half(p-1)];
+            const llu limit = n / p / p;
+            larges[0] -= (large)fp * (larges[position[half(p)]] - (large)below);
+            for(size_t k = position[half(p)] + 1; k < s && roughs[k] <= limit; k++)
+                larges[k] -= (large)fp * ((large)smalls[half(divide(n, roughs[k] * p))] - (large)below);
+        }
+        return larges[0];
+    }
+
+    // Number of primes <= n
+    lld primePi(llu n){return n < 2 ? 0 : lucy<CountPolicy>(n) + 1;}
+
+    // Sum of primes <= n; Fits in __int128 far beyond 10^13.
+    lll primeSum(llu n){return n < 2 ? 0 : lucy<SumPolicy>(n) + 2;}
+
+    std::string toString(lll x){
+        if(x == 0) return "0";
+        bool negative = x < 0;
+        std::string digits;
+        for(; x != 0; x /= 10) digits += (char)('0' + (int)(negative ? -(x % 10) : x % 10));
+        if(negative) digits += '-';
+        std::reverse(digits.begin(), digits.end());
+        return digits;
+    }
+
+    // Main solver function
+    void solve(){
+
+        int q; scanf("%d", &q);
+        while(q--){
+            llu n; scanf("%llu", &n);
+            printf("pi(%llu) = %lld, sum = %s\n", n, primePi(n), toString(primeSum(n)).c_str());
+        }
+    }
+
+}
+/*=============================================================================
+    int main();
+=============================================================================*/
+
+// Main
+int main(int argc, char **argv){
+#ifdef __McDic__ // Local testing
+    freopen("IO/input.txt", "r", stdin);
+    printf("================================================\n");
+    printf(" McDic's C++17 file execution for CP\n");
+    printf("================================================\n");
+    freopen("IO/output.txt", "w", stdout);
+    freopen("IO/debug.txt", "w", stderr);
+    auto startedTime = std::chrono::steady_clock::now();
+#endif
+
+    int testcases = 1; 
+    //std::cin >> testcases;
+    for(int t=1; t<=testcases; t++) McDicCP::solve();
+
+#ifdef __McDic__ // Local testing
+    auto endTime = std::chrono::steady_clock::now();
+    std::chrono::duration<double> duration = endTime - startedTime;
+    debugprintf("\n"); for(int i=0; i<80; i++) debugprintf("="); debugprintf("\n");
+    debugprintf("Total %.8lf ms used.\n", duration.count());
+#endif
+    return 0;
+}
\ No newline at end of file
@@ -1,32 +1,45 @@
 /*
 	Author: McDic
-	Description: Implementation of O(sqrt(n)) prime expanding.
+	Description: Implementation of incremental prime expanding by segmented sieve.
 */
 
 #include <stdio.h>
 #include <assert.h>
 #include <vector>
+#include <algorithm>
 
 // Constants
 typedef long long int lld;
+const lld SEGMENT = 1 << 16;
 
 // Attributes
 std::vector<bool> isPrime = {false, false, true};
 std::vector<lld> primes = {2};
 
-// Expand isPrime
-void expand_sqrt(const int limit){
-	while(isPrime.size() < limit){
-		isPrime.push_back(true);
-		lld num = isPrime.size() - 1;
-		for(auto p: primes){
-			if(p*p > num) break;
-			else if(num%p == 0){
-				isPrime[num] = false;
-				break;
-			}
+// Expand isPrime to cover [0, limit) and append new primes, one segment at a time.
+// A segment ending at high only needs primes below sqrt(high), so segments never pass
+// the square of the covered size. Calls can be repeated with growing limits.
+void expand(const lld limit){
+	lld low = isPrime.size();
+	if(limit <= low) return;
+	isPrime.resize(limit);
+	std::vector<char> segment;
+	while(low < limit){
+		const lld high = std::min(std::min(limit, low + SEGMENT), low * low);
+		segment.assign(high - low, 1);
+		for(size_t j=0; j<primes.size() && primes[j] * primes[j] < high; j++){
+			const lld p = primes[j];
+			for(lld m = std::max(p*p, (low + p - 1) / p * p); m < high; m += p) segment[m - low] = 0;
 		}
-		if(isPrime[num]) primes.push_back(num);
+
+		// Write back; primes grows once per segment
+		size_t index = primes.size();
+		primes.resize(index + std::count(segment.begin(), segment.end(), 1));
+		for(lld num=low; num<high; num++){
+			isPrime[num] = segment[num - low];
+			if(segment[num - low]) primes[index++] = num;
+		}
+		low = high;
 	}
 }
 
@@ -37,7 +50,7 @@ int main(void){
 	int n; scanf("%d", &n); assert(1<n);
 	
 	// Expand and show result
-	expand_sqrt(n);
+	expand(n);
 	printf("Primes under %d: ", n); 
 	for(auto p: primes) printf("%lld ", p);
 	printf("\n");
@@ -0,0 +1,44 @@
+/*
+	Author: McDic
+	Description: Generates or opens the memory mapped prime table in prime_table_mmap.h and factorizes with it.
+*/
+
+#include "prime_table_mmap.h"
+#include <chrono>
+
+typedef long long int lld;
+
+int main(int argc, char **argv){
+	
+	const char *path = argc > 1 ? argv[1] : "primes.bin";
+	const uint32_t limit = 30000005;
+	
+	// Generate only if missing or incompatible
+	PrimeTable table;
+	auto start = std::chrono::steady_clock::now();
+	if(!table.open(path)){
+		printf("Generating %s for numbers below %u...\n", path, limit);
+		if(!writePrimeTable(path, limit) || !table.open(path)){
+			printf("Failed to create %s\n", path);
+			return 1;
+		}
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	printf("Opened %s in %.1f us: %llu primes below %llu\n", path, elapsed.count() * 1e6,
+		(unsigned long long)table.primeCount(), (unsigned long long)table.limit());
+	
+	// Process queries
+	while(true){
+		printf("Input number to factorize(0 to exit): ");
+		lld num; if(scanf("%lld", &num) != 1 || num == 0) break;
+		if(num < 2 || (uint64_t)num >= table.limit()){
+			printf("Number should be in [2, %llu), please try again.\n", (unsigned long long)table.limit());
+			continue;
+		}
+		printf("%lld is %s:", num, table.isPrime(num) ? "prime" : "composite");
+		for(uint64_t x=num; x>1; x /= table.smallestPrimeFactor(x)) printf(" %llu", (unsigned long long)table.smallestPrimeFactor(x));
+		printf("\n");
+	}
+	
+	return 0;
+}
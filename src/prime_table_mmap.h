@@ -0,0 +1,168 @@
+/*
+	Author: McDic
+	Description: Persistent prime and smallest prime factor tables, memory mapped read-only.
+	Shared by prime_table_mmap.cpp, euler_function.cpp and eratosthenes_sieve.cpp.
+*/
+
+#ifndef __McDic_prime_table_mmap_h__
+#define __McDic_prime_table_mmap_h__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Constants
+const uint32_t TABLE_VERSION = 1;
+const uint32_t BYTE_ORDER_MARK = 0x01020304; // Reads back differently on a machine of other endianness
+const char TABLE_MAGIC[8] = {'M', 'C', 'D', 'P', 'R', 'I', 'M', 'E'};
+const uint64_t SECTION_ALIGN = 4096; // Sections start on page boundaries
+
+// File layout; Every section covers [0, limit) and only odd numbers are stored where possible.
+//   sieve:   bit i of 64-bit word i/64 is set iff 2i+1 is prime
+//   primes:  all primes below limit as uint32_t in increasing order
+//   factors: uint16_t smallest prime factor of odd 2i+1, 0 if prime; Composite n has one <= sqrt(n)
+struct PrimeTableHeader{
+	char magic[8];
+	uint32_t version, byteOrder;
+	uint64_t limit, primeCount;
+	uint64_t sieveOffset, primesOffset, factorsOffset, fileSize;
+};
+
+inline uint64_t alignUp(uint64_t x){return (x + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;}
+
+// Build tables below limit by linear sieve and write them to path.
+// Data goes to a temporary file which is renamed at the end, so readers never see a partial table.
+inline bool writePrimeTable(const char *path, uint32_t limit){
+	if(limit < 3) return false;
+	const uint64_t odds = limit / 2;
+	std::vector<uint16_t> factors(odds, 0);
+	std::vector<uint32_t> primes;
+	primes.push_back(2);
+	for(uint64_t i=3; i<limit; i+=2){
+		uint64_t f = factors[i/2];
+		if(f == 0) primes.push_back((uint32_t)i), f = i;
+		for(size_t j=1; j<primes.size() && primes[j] <= f && i*primes[j] < limit; j++)
+			factors[i*primes[j]/2] = (uint16_t)primes[j];
+	}
+	factors[0] = 1; // 1 is neither prime nor composite
+	std::vector<uint64_t> sieve((odds + 63) / 64, 0);
+	for(uint64_t i=1; i<odds; i++) if(factors[i] == 0) sieve[i/64] |= 1ULL << (i%64);
+
+	PrimeTableHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TABLE_MAGIC, sizeof(TABLE_MAGIC));
+	header.version = TABLE_VERSION, header.byteOrder = BYTE_ORDER_MARK;
+	header.limit = limit, header.primeCount = primes.size();
+	header.sieveOffset = alignUp(sizeof(header));
+	header.primesOffset = alignUp(header.sieveOffset + sieve.size() * sizeof(uint64_t));
+	header.factorsOffset = alignUp(header.primesOffset + primes.size() * sizeof(uint32_t));
+	header.fileSize = header.factorsOffset + factors.size() * sizeof(uint16_t);
+
+	// Unique temporary name, so concurrent writers never share one file
+	std::string temporary = std::string(path) + ".XXXXXX";
+	int fd = mkstemp(&temporary[0]);
+	if(fd < 0) return false;
+	FILE *file = (fchmod(fd, 0644) == 0 ? fdopen(fd, "wb") : nullptr);
+	if(!file){
+		::close(fd), remove(temporary.c_str());
+		return false;
+	}
+	auto writeAt = [file](uint64_t offset, const void *data, size_t bytes){
+		return fseek(file, (long)offset, SEEK_SET) == 0 && fwrite(data, 1, bytes, file) == bytes;
+	};
+	bool ok = writeAt(0, &header, sizeof(header))
+		&& writeAt(header.sieveOffset, sieve.data(), sieve.size() * sizeof(uint64_t))
+		&& writeAt(header.primesOffset, primes.data(), primes.size() * sizeof(uint32_t))
+		&& writeAt(header.factorsOffset, factors.data(), factors.size() * sizeof(uint16_t));
+	ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0; // Data must be on disk before rename makes it visible
+	ok = (fclose(file) == 0) && ok;
+	if(!ok || rename(temporary.c_str(), path) != 0){
+		remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+// Read-only view of a table file. Pages are shared between every process mapping the same file,
+// and opening costs one mmap and a header check regardless of limit.
+class PrimeTable{
+private:
+	const unsigned char *base;
+	size_t length;
+	const PrimeTableHeader *header;
+	const uint64_t *sieve;
+	const uint32_t *primeList;
+	const uint16_t *factors;
+
+public:
+	PrimeTable(): base(nullptr), length(0), header(nullptr), sieve(nullptr), primeList(nullptr), factors(nullptr){}
+	PrimeTable(const PrimeTable&) = delete;
+	PrimeTable &operator=(const PrimeTable&) = delete;
+	~PrimeTable(){close();}
+
+	// Map path; Returns false if it is missing, truncated, corrupt, or of other version or byte order.
+	bool open(const char *path){
+		close();
+		int fd = ::open(path, O_RDONLY);
+		if(fd < 0) return false;
+		struct stat info;
+		if(fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(PrimeTableHeader)){::close(fd); return false;}
+		void *mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd); // Mapping stays valid
+		if(mapped == MAP_FAILED) return false;
+		base = (const unsigned char*)mapped, length = info.st_size;
+		header = (const PrimeTableHeader*)base;
+		if(memcmp(header->magic, TABLE_MAGIC, sizeof(TABLE_MAGIC)) != 0 || header->version != TABLE_VERSION
+			|| header->byteOrder != BYTE_ORDER_MARK || header->fileSize != length){
+			close();
+			return false;
+		}
+
+		// Every section must lie inside the mapping, or a corrupt header would send reads out of bounds
+		const uint64_t limit = header->limit, odds = limit / 2;
+		auto fits = [this](uint64_t offset, uint64_t count, uint64_t size){
+			return offset >= sizeof(PrimeTableHeader) && offset % size == 0 && offset <= length
+				&& count <= (length - offset) / size;
+		};
+		if(limit < 3 || limit > UINT32_MAX || header->primeCount > odds + 1
+			|| !fits(header->sieveOffset, (odds + 63) / 64, sizeof(uint64_t))
+			|| !fits(header->primesOffset, header->primeCount, sizeof(uint32_t))
+			|| !fits(header->factorsOffset, odds, sizeof(uint16_t))){
+			close();
+			return false;
+		}
+		sieve = (const uint64_t*)(base + header->sieveOffset);
+		primeList = (const uint32_t*)(base + header->primesOffset);
+		factors = (const uint16_t*)(base + header->factorsOffset);
+		return true;
+	}
+	void close(){
+		if(base) munmap((void*)base, length);
+		base = nullptr, length = 0, header = nullptr;
+	}
+	bool isOpen() const{return base != nullptr;}
+
+	// Queries; n should be below limit() and i below primeCount().
+	uint64_t limit() const{return header->limit;}
+	uint64_t primeCount() const{return header->primeCount;}
+	uint32_t prime(size_t i) const{return primeList[i];}
+	const uint32_t *primeData() const{return primeList;} // primeCount() primes in increasing order
+	const uint16_t *factorData() const{return factors;} // Smallest prime factor of odd 2i+1 at i, 0 if prime
+	bool isPrime(uint64_t n) const{
+		if(n % 2 == 0) return n == 2;
+		return sieve[n/128] >> (n/2 % 64) & 1;
+	}
+	uint64_t smallestPrimeFactor(uint64_t n) const{ // n >= 2
+		if(n % 2 == 0) return 2;
+		return factors[n/2] ? factors[n/2] : n;
+	}
+};
+
+#endif
@@ -8,7 +8,6 @@
 
 // Constants
 typedef long long int lld;
-lld R = 1000 * 1000 * 1000 + 7;
 
 // Pretty bar
 void printBar(const int limit = 119){
@@ -16,8 +15,8 @@ void printBar(const int limit = 119){
 	printf("\n");
 }
 
-// Represents single node.
-class node{
+// Represents single node; T is the value type, such as lld or a modular integer type.
+template <typename T> class node{
 public:
 
 	// Node attributes
@@ -25,7 +24,7 @@ public:
 	node *childLeft, *childRight, *parent; // Parent and child nodes
 	
 	// Features
-	lld num; // Node's covering number and integrated features under this node
+	T num; // Node's covering number and integrated features under this node
 
 	// Constructor
 	node(int rangeLeft, int rangeRight, node *parent){
@@ -35,7 +34,7 @@ public:
 		this->parent = parent;
 		
 		// Feature initialization
-		this->num = 0;
+		this->num = T(0);
 
 		if(rangeLeft == rangeRight){ // Leaf node
 			this->childLeft = NULL;
@@ -76,7 +75,7 @@ public:
 	}
 	
 	// Change value for given range
-	void update(lld val, int targetIndex){
+	void update(T val, int targetIndex){
 		int dir = this->updateDirection(targetIndex, targetIndex);
         if(dir == 0) {
 			this->num = val; // Direct update
@@ -92,7 +91,7 @@ public:
 	}
 	
 	// Find sum for given lbound and rbound
-	lld search(int lbound, int rbound){
+	T search(int lbound, int rbound){
 		int dir = this->updateDirection(lbound, rbound);
         if(dir == 0){ // Direct found
 			//printf("Found fit (%lld, %lld): sum %lld\n", lbound, rbound, this->sum);
@@ -112,7 +111,7 @@ public:
 		for(int i=0; i<tabLevel-1; i++) printf("|   ");
 		if(tabLevel > 0) printf("+-- ");
 		printf("Node covering [%d, %d]: num %lld\n", 
-			this->rangeLeft, this->rangeRight, this->num);
+			this->rangeLeft, this->rangeRight, (lld)this->num);
 		if(!this->isLeaf()){
 			this->childLeft->print(tabLevel+1);
 			this->childRight->print(tabLevel+1);
@@ -135,7 +134,7 @@ int main(void){
 	}
 	
 	// Initialize segment tree
-	node *root = new node(1, n, NULL);
+	node<lld> *root = new node<lld>(1, n, NULL);
 	for(int i=0; i<n; i++) root->update(nums[i], i+1);
 	//printf("Tree initialized.\n\n"); root->print(0);
 	
@@ -6,35 +6,70 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <map>
-#include <utility>
 
 typedef long long int lld;
 
-// 1e8, 9e7, 8e7, 7e7, 6e7, 5e7-th prime numbers
-const std::vector<lld> keys = {2038074743LL, 1824261409LL, 1611623773LL};//, 1400305337LL, 1190494759LL, 982451653LL};
+// Modular integer with compile-time modulus M <= 2^31; Every % has a constant divisor,
+// so the compiler turns it into multiplications.
+template <unsigned int M> class ModInt{
+	static_assert(1 <= M && M <= (1U << 31), "Sum of two residues should fit in 32 bits");
+public:
+	unsigned int value;
+	constexpr ModInt(): value(0){}
+	constexpr ModInt(lld x): value((unsigned int)(x % (lld)M < 0 ? x % (lld)M + M : x % (lld)M)){}
+	static constexpr unsigned int modulus(){return M;}
+	constexpr explicit operator lld() const{return value;}
+
+	ModInt &operator +=(const ModInt &another){value += another.value; if(value >= M) value -= M; return *this;}
+	ModInt &operator -=(const ModInt &another){value += M - another.value; if(value >= M) value -= M; return *this;}
+	ModInt &operator *=(const ModInt &another){value = (unsigned int)((unsigned long long)value * another.value % M); return *this;}
+	ModInt &operator /=(const ModInt &another){return *this *= another.inverse();}
+	ModInt operator -() const{return ModInt() -= *this;}
+	friend ModInt operator +(ModInt a, const ModInt &b){return a += b;}
+	friend ModInt operator -(ModInt a, const ModInt &b){return a -= b;}
+	friend ModInt operator *(ModInt a, const ModInt &b){return a *= b;}
+	friend ModInt operator /(ModInt a, const ModInt &b){return a /= b;}
+	friend constexpr bool operator ==(const ModInt &a, const ModInt &b){return a.value == b.value;}
+	friend constexpr bool operator !=(const ModInt &a, const ModInt &b){return a.value != b.value;}
 
-// Fast power with memorization
-std::map<std::pair<lld, std::pair<lld, lld>>, lld> savePower;
-lld power(int a, int p, lld r){
-	std::pair<lld, std::pair<lld, lld>> key = std::make_pair(a, std::make_pair(p, r));
-	if(savePower.find(key) != savePower.end()) return savePower[key];
-	else if(p==0) savePower[key] = 1;
-	else{
-		lld half = power(a, p/2, r);
-		if(p%2 == 0) savePower[key] = half*half%r;
-		else savePower[key] = half*half%r*a%r;
+	ModInt pow(unsigned long long n) const{
+		ModInt result(1), x = *this;
+		for(; n; n >>= 1, x *= x) if(n&1) result *= x;
+		return result;
 	}
-	return savePower[key];
-}
+	// Extended Euclid; value should be coprime to M
+	ModInt inverse() const{
+		lld a = value, b = M, x = 1, y = 0;
+		while(b){
+			lld q = a / b, t = a - q * b; a = b, b = t;
+			t = x - q * y; x = y, y = t;
+		}
+		return ModInt(x);
+	}
+};
 
-// Calculate partial hash
-lld partialHash(int lbound, int rbound, lld R, const std::vector<lld> &hashvec){
-	lld hashL = (lbound > 0 ? hashvec[lbound-1]:0), hashR = hashvec[rbound];
-	lld newHash = (hashR - hashL * power(128, rbound-lbound+1, R) % R) % R;
-	if(newHash < 0) newHash += R;
-	return newHash;
-}
+// 1e8, 9e7, 8e7, 7e7, 6e7, 5e7-th prime numbers
+const unsigned int KEY0 = 2038074743U, KEY1 = 1824261409U, KEY2 = 1611623773U;//, 1400305337U, 1190494759U, 982451653U;
+
+// Polynomial hash with base 128 over mint = ModInt<key>
+template <typename mint> class PolynomialHash{
+public:
+	std::vector<mint> prefix, powers; // prefix[i] = hash(s[0~i-1]), powers[i] = 128^i
+	
+	PolynomialHash(const std::string &s): prefix(s.length() + 1), powers(s.length() + 1){
+		powers[0] = 1;
+		for(int i=0; i<s.length(); i++){
+			prefix[i+1] = prefix[i] * 128 + s[i];
+			powers[i+1] = powers[i] * 128;
+		}
+	}
+	
+	// hash(s[lbound~rbound])
+	mint partialHash(int lbound, int rbound) const{
+		return prefix[rbound+1] - prefix[lbound] * powers[rbound-lbound+1];
+	}
+	mint wholeHash() const{return prefix.back();}
+};
 
 int main(void){
 	
@@ -42,37 +77,18 @@ int main(void){
 	std::getline(std::cin, origin);
 	std::getline(std::cin, target);
 	
-	// Store hash value
-	std::vector<lld> hashes[keys.size()]; // hashes[h][i] = hash(origin[0~i]) mod key[h] 
-	lld targetHashes[keys.size()] = {0, }; // targetHashes[h] = hash(target) mod keys[h]
-	
-	// Hash pre-calculation
-	for(int h=0; h<keys.size(); h++){
-		
-		// hash(origin[0~i]) mod keys[h]
-		lld base = 0;
-		for(int i=0; i<origin.length(); i++){
-			base = (base*128%keys[h] + origin[i]) % keys[h];
-			hashes[h].push_back(base);
-		}
-		
-		// hash(target) mod keys[h]
-		targetHashes[h] = 0;
-		for(int i=0; i<target.length(); i++) targetHashes[h] = (targetHashes[h]*128%keys[h] + target[i]) % keys[h];
-	}
+	// Hash pre-calculation for each key
+	PolynomialHash<ModInt<KEY0>> origin0(origin), target0(target);
+	PolynomialHash<ModInt<KEY1>> origin1(origin), target1(target);
+	PolynomialHash<ModInt<KEY2>> origin2(origin), target2(target);
 	
 	// Calculate
-	std::vector<int> occurences;	//printf("0 <= origin.length() - target.length() = %d -> %d\n", origin.length() - target.length(), 0 <= (int)(origin.length() - target.length()));
+	std::vector<int> occurences;
 	for(int head=0; head <= (int)origin.length() - (int)target.length(); head++){
-		bool allSame = true;
-		for(int h=0; h<keys.size(); h++){ // hash(target) == hash(origin[head~head+len(target)-1) mod keys[h] ?
-			lld partialHashed = partialHash(head, head+target.length()-1, keys[h], hashes[h]);
-			if(partialHashed != targetHashes[h]){
-				allSame = false;
-				break;
-			}
-		}
-		if(allSame)	occurences.push_back(head);
+		int tail = head + target.length() - 1; // hash(target) == hash(origin[head~tail]) for every key?
+		if(origin0.partialHash(head, tail) == target0.wholeHash()
+			&& origin1.partialHash(head, tail) == target1.wholeHash()
+			&& origin2.partialHash(head, tail) == target2.wholeHash()) occurences.push_back(head);
 	}
 	
 	printf("%d\n", occurences.size());
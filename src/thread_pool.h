@@ -0,0 +1,86 @@
+/*
+	Author: McDic
+	Description: Persistent worker threads for fork-join loops.
+	Shared by eratosthenes_sieve.cpp and matrix_power.cpp.
+*/
+
+#ifndef __McDic_thread_pool_h__
+#define __McDic_thread_pool_h__
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Workers are started on first demand and then sleep between calls, so repeated
+// parallel loops do not pay for thread creation each time.
+class ThreadPool{
+private:
+	std::vector<std::thread> workers;
+	std::mutex lock, running; // running serializes concurrent run() calls
+	std::condition_variable wake, done;
+	const std::function<void(unsigned int)> *task;
+	unsigned int tasks, next, finished;
+	unsigned long long generation; // Bumped once per run() so sleeping workers notice new work
+	bool stopping;
+
+	// Run pending tasks until none is left; lock must be held and is held again on return.
+	void drain(std::unique_lock<std::mutex> &guard){
+		while(next < tasks){
+			const unsigned int index = next++;
+			guard.unlock();
+			(*task)(index);
+			guard.lock();
+			if(++finished == tasks) done.notify_all();
+		}
+	}
+
+	// seen is the generation at creation, so a worker started by run() still joins that run.
+	void loop(unsigned long long seen){
+		std::unique_lock<std::mutex> guard(lock);
+		for(;;){
+			wake.wait(guard, [&]{return stopping || generation != seen;});
+			if(stopping) return;
+			seen = generation;
+			drain(guard);
+		}
+	}
+
+public:
+	ThreadPool(): task(nullptr), tasks(0), next(0), finished(0), generation(0), stopping(false){}
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool &operator=(const ThreadPool&) = delete;
+	~ThreadPool(){
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			stopping = true;
+		}
+		wake.notify_all();
+		for(auto &worker: workers) worker.join();
+	}
+
+	// Call fn(i) once for every i < count on up to count threads, and return after all finished.
+	// The calling thread takes part, so count-1 workers are kept alive for the next call.
+	void run(unsigned int count, const std::function<void(unsigned int)> &fn){
+		if(count == 0) return;
+		if(count == 1){fn(0); return;}
+		std::lock_guard<std::mutex> serial(running);
+		std::unique_lock<std::mutex> guard(lock);
+		while(workers.size() + 1 < count) workers.emplace_back(&ThreadPool::loop, this, generation);
+		task = &fn, tasks = count, next = 0, finished = 0;
+		generation++;
+		wake.notify_all();
+		drain(guard);
+		done.wait(guard, [&]{return finished == tasks;});
+		task = nullptr;
+	}
+};
+
+// One pool per process, shared by every parallel loop
+inline ThreadPool &sharedPool(){
+	static ThreadPool pool;
+	return pool;
+}
+
+#endif
@@ -0,0 +1,50 @@
+/*
+	Author: McDic
+	Description: Checks that Fraction<BigInt> defers reduction through an arithmetic chain
+	instead of running gcd on every result, and that Fraction<__int128> reduces with its full width.
+	Build from repository root (gnu++ makes __int128 integral):
+	g++ -O2 -std=gnu++14 tests/fraction_lazy_reduction.cpp
+*/
+
+#define main bigIntegerMain
+#include "../src/big_integer.cpp"
+#undef main
+#define main fractionMain
+#include "../src/fraction.cpp"
+#undef main
+
+int main(void){
+
+	// H(n) = 1/1 + ... + 1/n by +, scaled by * with small fractions on every third step.
+	// Eager reduction would leave every step reduced once past LAZY_SLACK_BITS;
+	// Lazy reduction should still reduce now and then, or sizes grow without bound.
+	const int STEPS = 400;
+	Fraction<BigInt> lazy(BigInt(0)), eager(BigInt(0));
+	int reducedSteps = 0;
+	for(int i=1; i<=STEPS; i++){
+		Fraction<BigInt> term(BigInt(1), BigInt(i)), scale(BigInt(i+1), BigInt(i));
+		lazy += term, eager += term;
+		if(lazy.reduced()) reducedSteps++;
+		if(i % 3 == 0) lazy *= scale, eager *= scale;
+		eager.make_pair(); // Forces reduction
+	}
+	if(reducedSteps == 0 || reducedSteps * 4 > STEPS){
+		printf("FAIL: %d of %d steps were reduced\n", reducedSteps, STEPS);
+		return 1;
+	}
+	if(lazy.make_pair() != eager.make_pair()){
+		printf("FAIL: lazy and eager results differ\n");
+		return 1;
+	}
+	printf("OK: %d of %d steps reduced\n", reducedSteps, STEPS);
+
+	// 3 * 2^70 / (6 * 2^70) needs all 128 bits in gcd
+	const __int128 big = (__int128)1 << 70;
+	auto half = Fraction<__int128>(3 * big, 6 * big).make_pair();
+	if(half.first != 1 || half.second != 2){
+		printf("FAIL: 3*2^70 / 6*2^70 did not reduce to 1/2\n");
+		return 1;
+	}
+	printf("OK: __int128 fraction reduced to 1/2\n");
+	return 0;
+}